@@ -1,5 +1,10 @@
+#include <Events.h>
+#include <Files.h>
+#include <Folders.h>
+#include <Gestalt.h>
 #include <Memory.h>
 #include <OSUtils.h>
+#include <Resources.h>
 #include <TextEdit.h>
 #include <stdio.h>
 #include <stdlib.h>
@@ -8,676 +13,761 @@
 
 #include "../constants.h"
 #include "markov.h"
+#include "markov_beam.h"
 #include "markov_data.h"
+#include "markov_mixture.h"
+#include "markov_reply.h"
+#include "random.h"
+#include "text_builder.h"
+
+/* Sampling: temperature in percent, 100 samples the trained frequencies, and the most frequent
+ * followers considered, 0 for all of them */
+#ifndef MARKOV_TEMPERATURE
+#define MARKOV_TEMPERATURE MARKOV_DEFAULT_TEMPERATURE
+#endif
+#ifndef MARKOV_TOP_K
+#define MARKOV_TOP_K MARKOV_DEFAULT_TOP_K
+#endif
+
+/* Best-of-N replies: candidates generated per reply, as many as fit in the reply budget */
+#ifndef MARKOV_CANDIDATES
+#define MARKOV_CANDIDATES 4
+#endif
+
+/* Beam search decoding: sentences decoded as the most likely of MARKOV_BEAM_WIDTH partial
+ * sentences rather than sampled one word at a time. A width of 1 samples */
+#ifndef MARKOV_BEAM_WIDTH
+#define MARKOV_BEAM_WIDTH 1
+#endif
+
+/* Chain saved in the Preferences folder so what was learned survives a restart. A short header
+ * names the precompiled model it grew from, followed by the chain in the model format */
+#define kChainFileName "\pAI Markov Chain"
+#define kChainFileMagic 'MKVC'
+#define kChainFileType kChainFileMagic
+#define kChainFileCreator 'MKAI'
+#define kChainFileVersion 2 /* Words of the base model keep their IDs, for the topic sub-models */
+#define kChainFileHeaderSize 10 /* magic, version, base model checksum */
+#define kModelHeaderBytes 18    /* Enough of a model to read its checksum and word count */
+
+/* Chain memory budget. The chain is sized when the model is selected, from what the heap can
+ * spare, and released again when another model takes over */
+#ifndef MARKOV_HEAP_PERCENT
+#define MARKOV_HEAP_PERCENT 50 /* Most of the free heap, in percent, a chain may take */
+#endif
+#define kMarkovHeapReserve (64L * 1024) /* Left free for windows, TextEdit and replies */
+#define kMarkovRAMShare 16              /* Never more than this fraction of physical RAM */
+#define kChainSizeStep 256              /* Contexts given up per step when memory is short */
+
+/* Topic sub-models: the most a prompt is routed to, which are also the most kept loaded, and the
+ * share of each reply's mixture they get between them. The general chain gets the rest */
+#define kMaxTopics (kMaxMixtureChains - 1)
+#define kTopicMixPercent 60
+
+/* Background training: entries trained per idle call, and the next static corpus entry. Past
+ * the static corpus come the system facts, then the chain is ready */
+#define kTrainingSliceEntries 4
+#define kTrainingDone -1
+
+/* Volatile facts: the system facts, such as the time and free memory, go stale. They are kept
+ * as trained so a refresh can take them back out and train their current values instead */
+#define kMaxMarkovFacts 12
+#define kMaxFactLength 80
+#define kFactRefreshTicks (60L * 60) /* A minute, the finest the clock and uptime facts go */
+
+/* Global Markov chain data, NULL while another model is active */
+static MarkovChain *gMarkovChain = NULL;
+
+/* Bytes more the heap needed for a chain the precompiled model fits, when there is no chain */
+static long gMarkovShortfall = 0;
+
+/* Topic sub-models sharing the general chain's dictionary, NULL while not loaded */
+static MarkovChain *gTopicChains[kMarkovTopicCount];
+static unsigned long gTopicUsed[kMarkovTopicCount]; /* Reply each was last routed to */
+static unsigned long gTopicReplies = 0;             /* Replies routed so far */
+
+/* Words of the precompiled model, which the sub-models were built on; 0 if they can't be used */
+static short gTopicWords = 0;
+
+/* Where background training is, kTrainingDone once the chain is complete */
+static short gTrainingCursor = kTrainingDone;
+
+/* Sampling settings every chain gets, as loading a chain resets its own */
+static short gMarkovTemperature = MARKOV_TEMPERATURE;
+static short gMarkovTopK        = MARKOV_TOP_K;
+
+/* Candidates generated per reply, 1 for a single random walk */
+static short gMarkovCandidates = MARKOV_CANDIDATES;
+
+/* Hypotheses kept while beam decoding, 1 to sample instead */
+static short gMarkovBeamWidth = MARKOV_BEAM_WIDTH;
+
+/* The facts trained into the chain now, and when */
+static char gMarkovFacts[kMaxMarkovFacts][kMaxFactLength];
+static short gMarkovFactCount = 0;
+static unsigned long gMarkovFactTicks;
+
+/* Whether user prompts are trained into the chain */
+static Boolean gMarkovLearning = FALSE;
+
+/* The chain changed since it was loaded, so it should be saved */
+static Boolean gMarkovChainDirty = FALSE;
+
+/* Random numbers for generating replies, from the session seed */
+static RandomStream gRandom;
 
-/* Markov chain data structure with bigram model (state_size=2) */
-#define MAX_WORDS 384       /* Reduced to make room for more data per word */
-#define MAX_FOLLOWERS 8     /* Reduced to make room for frequencies */
-#define MAX_WORD_LENGTH 24  /* Reduced slightly to save memory */
-#define MAX_STATE_LENGTH 48 /* For state (two words) */
+/* Train the Markov chain with new text using bigram model */
+void TrainMarkov(const char *text)
+{
+    MarkovChain_Train(gMarkovChain, text);
+}
 
-/* New: Weighted followers to improve text quality */
-typedef struct {
-    char word[MAX_WORD_LENGTH];
-    unsigned char frequency; /* Track how often this follower appears */
-} WeightedFollower;
+/* Train the Markov chain on a volatile fact, remembering it for the next refresh */
+void TrainMarkovFact(const char *text)
+{
+    char *fact;
 
-typedef struct {
-    char state[MAX_STATE_LENGTH]; /* The state is now two words combined */
-    WeightedFollower followers[MAX_FOLLOWERS];
-    unsigned char followerCount;
-    unsigned char isStartOfSentence : 1; /* Flag for sentence starters */
-} MarkovNode;
+    /* A fact that can't be remembered couldn't be taken back out again */
+    if (gMarkovFactCount == kMaxMarkovFacts)
+        return;
+
+    fact = gMarkovFacts[gMarkovFactCount++];
+    strncpy(fact, text, kMaxFactLength - 1);
+    fact[kMaxFactLength - 1] = '\0';
+    MarkovChain_Train(gMarkovChain, fact);
+}
 
-/* Global Markov chain data */
-static MarkovNode gMarkovChain[MAX_WORDS];
-static short gMarkovNodeCount = 0;
+/* Take the volatile facts back out of the chain; they are still remembered */
+static void UntrainMarkovFacts(void)
+{
+    short i;
 
-/* Global random seed */
-static unsigned long gRandomSeed = 1;
+    for (i = 0; i < gMarkovFactCount; i++) {
+        MarkovChain_Untrain(gMarkovChain, gMarkovFacts[i]);
+    }
+}
 
-/* Custom random number generator - named differently to avoid conflicts */
-static unsigned long RandomGen(void)
+/* Replace the volatile facts with their current values, costing only their own training */
+static void RefreshMarkovFacts(void)
 {
-    gRandomSeed = gRandomSeed * 1103515245 + 12345;
-    return (gRandomSeed >> 16) & 0x7FFF;
+    UntrainMarkovFacts();
+    gMarkovFactCount = 0;
+    LoadDynamicTrainingData();
+    gMarkovFactTicks = TickCount();
 }
 
-/* Initialize the random seed */
-static void InitRandom(void)
+/* Turn learning from user prompts on or off */
+void SetMarkovLearning(Boolean enabled)
 {
-    /* Use the system time to seed the random number generator */
-    DateTimeRec dateTime;
-    GetTime(&dateTime);
+    gMarkovLearning = enabled;
+    if (IsMarkovReady())
+        MarkovChain_SetEviction(gMarkovChain, enabled);
+}
 
-    /* Seed our custom random function with current time */
-    gRandomSeed = (dateTime.hour * 3600) + (dateTime.minute * 60) + dateTime.second + dateTime.year;
+/* Check whether the Markov chain learns from user prompts */
+Boolean IsMarkovLearning(void)
+{
+    return gMarkovLearning;
 }
 
-/* Hash function for faster state lookup */
-static unsigned short HashString(const char *state)
+/* Train the Markov chain on a user prompt if learning is on */
+void LearnMarkovPrompt(const TokenList *prompt)
 {
-    unsigned short hash = 0;
-    while (*state) {
-        hash = (hash * 31) + *state++;
+    /* Prompts are only learned once the corpus is in, so they can't crowd it out */
+    if (gMarkovLearning && IsMarkovReady()) {
+        MarkovChain_TrainTokens(gMarkovChain, prompt);
+        gMarkovChainDirty = TRUE;
     }
-    return hash % MAX_WORDS;
 }
 
-/* Find a state in the Markov chain, returns index or -1 if not found */
-static short FindStateInChain(const char *state)
+/* Read the precompiled model's header, returns FALSE if there is no model */
+static Boolean ReadPrecompiledHeader(unsigned char *header)
 {
-    /* Start search at the hash position for better performance */
-    short startIdx = HashString(state);
-    short i;
-
-    /* First search from hash position to end */
-    for (i = startIdx; i < gMarkovNodeCount; i++) {
-        if (strcmp(gMarkovChain[i].state, state) == 0) {
-            return i;
-        }
-    }
+    Boolean read;
+    Handle model;
+
+    /* Only the header is needed, so don't load the whole resource */
+    SetResLoad(FALSE);
+    model = GetResource(MARKOV_MODEL_RES_TYPE, MARKOV_MODEL_RES_ID);
+    SetResLoad(TRUE);
+    if (model == NULL)
+        return FALSE;
 
-    /* Then search from beginning to hash position if needed */
-    for (i = 0; i < startIdx && i < gMarkovNodeCount; i++) {
-        if (strcmp(gMarkovChain[i].state, state) == 0) {
-            return i;
-        }
-    }
+    ReadPartialResource(model, 0, header, kModelHeaderBytes);
+    read = ResError() == noErr;
+    ReleaseResource(model);
 
-    return -1;
+    return read;
 }
 
-/* Add a state to the Markov chain, returns index */
-static short AddStateToChain(const char *state, Boolean isStart)
+/* Checksum of the precompiled model, read from its header alone; 0 if there is none */
+static unsigned long PrecompiledModelChecksum(void)
 {
-    if (gMarkovNodeCount < MAX_WORDS) {
-        strncpy(gMarkovChain[gMarkovNodeCount].state, state, MAX_STATE_LENGTH - 1);
-        gMarkovChain[gMarkovNodeCount].state[MAX_STATE_LENGTH - 1] = '\0';
-        gMarkovChain[gMarkovNodeCount].followerCount               = 0;
-        gMarkovChain[gMarkovNodeCount].isStartOfSentence           = isStart;
-        return gMarkovNodeCount++;
-    }
-    return -1; /* Chain is full */
+    unsigned char header[kModelHeaderBytes];
+
+    return ReadPrecompiledHeader(header) ? MarkovChain_ModelChecksum(header, kModelHeaderBytes)
+                                         : 0;
 }
 
-/* Add or update a follower to a state in the chain */
-static void AddFollower(short stateIndex, const char *follower)
+/* Words in the precompiled model's dictionary, from its header alone; 0 if there is none */
+static short PrecompiledModelWords(void)
 {
-    MarkovNode *node = &gMarkovChain[stateIndex];
-    short i;
-
-    /* Check if we already have this follower */
-    for (i = 0; i < node->followerCount; i++) {
-        if (strcmp(node->followers[i].word, follower) == 0) {
-            /* Found existing follower, increment frequency (up to 255) */
-            if (node->followers[i].frequency < 255) {
-                node->followers[i].frequency++;
-            }
-            return;
-        }
-    }
+    unsigned char header[kModelHeaderBytes];
 
-    /* Add new follower if there's space */
-    if (node->followerCount < MAX_FOLLOWERS) {
-        strncpy(node->followers[node->followerCount].word, follower, MAX_WORD_LENGTH - 1);
-        node->followers[node->followerCount].word[MAX_WORD_LENGTH - 1] = '\0';
-        node->followers[node->followerCount].frequency = 1; /* Initialize frequency */
-        node->followerCount++;
-    }
-    else {
-        /* Chain is full for this state, potentially replace a random low-frequency follower */
-        short replace_idx = RandomGen() % MAX_FOLLOWERS;
-        if (node->followers[replace_idx].frequency == 1) {
-            strncpy(node->followers[replace_idx].word, follower, MAX_WORD_LENGTH - 1);
-            node->followers[replace_idx].word[MAX_WORD_LENGTH - 1] = '\0';
-            node->followers[replace_idx].frequency                 = 1;
-        }
-    }
+    return ReadPrecompiledHeader(header) ? MarkovChain_ModelWords(header, kModelHeaderBytes) : 0;
 }
 
-/* Helper function to check if a char is sentence ending punctuation */
-static Boolean IsSentenceEnder(char c)
+/* Read a big-endian 32-bit value from a chain file header */
+static unsigned long GetChainFileLong(const unsigned char *p)
 {
-    return (c == '.' || c == '!' || c == '?');
+    return ((unsigned long)p[0] << 24) | ((unsigned long)p[1] << 16) | (p[2] << 8) | p[3];
 }
 
-/* Helper function to combine two words into a state */
-static void MakeState(const char *word1, const char *word2, char *state_buffer)
+/* Store a big-endian 32-bit value in a chain file header */
+static void PutChainFileLong(unsigned char *p, unsigned long value)
 {
-    strcpy(state_buffer, word1);
-    strcat(state_buffer, " ");
-    strcat(state_buffer, word2);
+    p[0] = value >> 24;
+    p[1] = (value >> 16) & 0xFF;
+    p[2] = (value >> 8) & 0xFF;
+    p[3] = value & 0xFF;
 }
 
-/* Clean and check if word ends a sentence */
-static Boolean CleanWord(char *word, Boolean *isEndOfSentence)
+/* Locate the saved chain in the Preferences folder, returns FALSE if there's no such folder */
+static Boolean GetChainFileSpec(Boolean createFolder, FSSpec *spec)
 {
-    char *p;
-    size_t len;
+    short vRefNum;
+    long dirID;
+    OSErr err;
 
-    if (!word || !*word)
+    if (FindFolder(kOnSystemDisk, kPreferencesFolderType, createFolder, &vRefNum, &dirID) != noErr)
         return FALSE;
 
-    len = strlen(word);
-    if (len == 0)
-        return FALSE;
+    /* fnfErr still makes a valid spec, for a file not created yet */
+    err = FSMakeFSSpec(vRefNum, dirID, kChainFileName, spec);
+    return err == noErr || err == fnfErr;
+}
 
-    /* Check for sentence ending punctuation */
-    p                = word + len - 1;
-    *isEndOfSentence = IsSentenceEnder(*p);
+/* Load the chain saved by an earlier session, returns FALSE if it's missing, damaged or was
+ * built from a different precompiled model than the one we have now */
+static Boolean LoadSavedChain(void)
+{
+    const unsigned char *data;
+    Boolean loaded = FALSE;
+    FSSpec spec;
+    short refNum;
+    long size;
+    Ptr file;
+
+    if (!GetChainFileSpec(kDontCreateFolder, &spec) || FSpOpenDF(&spec, fsRdPerm, &refNum) != noErr)
+        return FALSE;
 
-    /* Remove punctuation except sentence enders */
-    while (p > word && strchr(".,!?;:", *p)) {
-        if (!IsSentenceEnder(*p))
-            *p = '\0';
-        p--;
+    /* Read the whole file in one go; the chain format is built to be parsed in place */
+    if (GetEOF(refNum, &size) == noErr && size > kChainFileHeaderSize &&
+        (file = NewPtr(size)) != NULL) {
+        data = (const unsigned char *)file;
+
+        /* Check the header before the slower checksum and structure checks in the load */
+        if (FSRead(refNum, &size, file) == noErr && GetChainFileLong(data) == kChainFileMagic &&
+            ((data[4] << 8) | data[5]) == kChainFileVersion &&
+            GetChainFileLong(data + 6) == PrecompiledModelChecksum()) {
+            loaded = MarkovChain_Load(gMarkovChain, data + kChainFileHeaderSize,
+                                      size - kChainFileHeaderSize);
+        }
+        DisposePtr(file);
     }
 
-    return TRUE;
+    FSClose(refNum);
+    return loaded;
 }
 
-/* Train the Markov chain with new text using bigram model */
-void TrainMarkov(const char *text)
+/* Save the chain for the next launch if learning changed it */
+void SaveMarkovChain(void)
 {
-    char buffer[kMaxPromptLength];
-    char *word1, *word2, *word3;
-    char state_buffer[MAX_STATE_LENGTH];
-    short stateIndex, newStateIndex;
-    Boolean newSentence = TRUE;
-    Boolean endsFirst   = FALSE;
-
-    if (!text || !*text)
+    unsigned char *data;
+    long size, modelSize;
+    FSSpec spec;
+    short refNum, i;
+    OSErr err;
+    Ptr file;
+
+    if (!gMarkovChainDirty || gMarkovChain == NULL)
         return;
 
-    /* Make a copy we can modify */
-    strncpy(buffer, text, kMaxPromptLength - 1);
-    buffer[kMaxPromptLength - 1] = '\0';
-
-    /* Get first word */
-    word1 = strtok(buffer, " \r\n\t");
-    if (!CleanWord(word1, &endsFirst))
+    /* Facts are trained fresh every launch, so they are left out rather than pile up */
+    UntrainMarkovFacts();
+    modelSize = MarkovChain_SavedSize(gMarkovChain);
+    size      = kChainFileHeaderSize + modelSize;
+    file      = NewPtr(size);
+    if (file == NULL)
         return;
 
-    /* Get second word */
-    word2 = strtok(NULL, " \r\n\t");
-    if (!CleanWord(word2, &endsFirst))
-        return;
-
-    /* Create the first state (word1 + word2) and find or add it */
-    MakeState(word1, word2, state_buffer);
-    stateIndex = FindStateInChain(state_buffer);
-
-    if (stateIndex < 0) {
-        stateIndex = AddStateToChain(state_buffer, newSentence);
-        if (stateIndex < 0)
-            return; /* Chain is full */
+    data = (unsigned char *)file;
+    PutChainFileLong(data, kChainFileMagic);
+    data[4] = kChainFileVersion >> 8;
+    data[5] = kChainFileVersion & 0xFF;
+    PutChainFileLong(data + 6, PrecompiledModelChecksum());
+    MarkovChain_Save(gMarkovChain, data + kChainFileHeaderSize, modelSize);
+    for (i = 0; i < gMarkovFactCount; i++) {
+        MarkovChain_Train(gMarkovChain, gMarkovFacts[i]);
     }
-    else if (newSentence) {
-        /* Mark existing state as a sentence starter */
-        gMarkovChain[stateIndex].isStartOfSentence = TRUE;
+
+    /* A partly written file fails its checksum next launch, and the app falls back */
+    if (GetChainFileSpec(kCreateFolder, &spec)) {
+        err = FSpCreate(&spec, kChainFileCreator, kChainFileType, smSystemScript);
+        if (err == dupFNErr)
+            err = noErr; /* Overwrite the previous session's chain */
+
+        if (err == noErr && FSpOpenDF(&spec, fsWrPerm, &refNum) == noErr) {
+            if (FSWrite(refNum, &size, file) == noErr)
+                SetEOF(refNum, size);
+            FSClose(refNum);
+            FlushVol(NULL, spec.vRefNum);
+            gMarkovChainDirty = FALSE;
+        }
     }
 
-    /* Process all words and add them to the chain */
-    while ((word3 = strtok(NULL, " \r\n\t")) != NULL) {
-        Boolean wordEndsWithPunctuation;
+    DisposePtr(file);
+}
 
-        /* Check if previous word ended a sentence */
-        newSentence = endsFirst || (strlen(word2) > 0 && IsSentenceEnder(word2[strlen(word2) - 1]));
+/* Load the precompiled static corpus model from the application's resources */
+static Boolean LoadPrecompiledModel(void)
+{
+    Handle model;
+    Boolean loaded;
 
-        /* Clean current word */
-        if (!CleanWord(word3, &wordEndsWithPunctuation))
-            continue;
+    model = GetResource(MARKOV_MODEL_RES_TYPE, MARKOV_MODEL_RES_ID);
+    if (model == NULL)
+        return FALSE;
 
-        /* Add word3 as a follower to the current state */
-        AddFollower(stateIndex, word3);
+    HLock(model);
+    loaded = MarkovChain_Load(gMarkovChain, (const unsigned char *)*model, GetHandleSize(model));
+    HUnlock(model);
+    ReleaseResource(model);
 
-        /* Create and add the new state (word2 + word3) */
-        MakeState(word2, word3, state_buffer);
-        newStateIndex = FindStateInChain(state_buffer);
+    return loaded;
+}
 
-        if (newStateIndex < 0) {
-            newStateIndex = AddStateToChain(state_buffer, newSentence);
-            if (newStateIndex < 0)
-                break; /* Chain is full */
-        }
-        else if (newSentence) {
-            /* Mark existing state as a sentence starter */
-            gMarkovChain[newStateIndex].isStartOfSentence = TRUE;
-        }
+/* Unload a topic sub-model, giving its references to the shared words back first */
+static void UnloadTopic(short topic)
+{
+    if (gTopicChains[topic] == NULL)
+        return;
 
-        /* Move to the next state */
-        stateIndex = newStateIndex;
-        word1      = word2;
-        word2      = word3;
-        endsFirst  = wordEndsWithPunctuation;
-    }
+    MarkovChain_Reset(gTopicChains[topic]);
+    DisposePtr((Ptr)gTopicChains[topic]);
+    gTopicChains[topic] = NULL;
 }
 
-/* Initialize the Markov chain with data from markov_data.c */
-static void InitMarkovChain(void)
+/* Unload every topic sub-model, as before the general chain's dictionary is replaced */
+static void UnloadTopics(void)
 {
-    gMarkovNodeCount = 0;
+    short topic;
 
-    /* Training data is provided in markov_data.c */
-    LoadTrainingData();
+    for (topic = 0; topic < kMarkovTopicCount; topic++) {
+        UnloadTopic(topic);
+    }
 }
 
-/* Select a follower based on weighted probabilities */
-static short SelectWeightedFollower(const MarkovNode *node)
+/* Unload the least recently used topic sub-model this reply wasn't routed to, FALSE if none */
+static Boolean UnloadStaleTopic(void)
 {
-    if (node->followerCount == 0)
-        return -1;
+    short topic, stalest = -1;
 
-    /* Calculate total frequency */
-    unsigned short totalWeight = 0;
-    short i;
-
-    for (i = 0; i < node->followerCount; i++) {
-        totalWeight += node->followers[i].frequency;
+    for (topic = 0; topic < kMarkovTopicCount; topic++) {
+        if (gTopicChains[topic] != NULL && gTopicUsed[topic] != gTopicReplies &&
+            (stalest < 0 || gTopicUsed[topic] < gTopicUsed[stalest]))
+            stalest = topic;
     }
+    if (stalest < 0)
+        return FALSE;
+
+    UnloadTopic(stalest);
+    return TRUE;
+}
+
+/* Number of topic sub-models loaded */
+static short LoadedTopics(void)
+{
+    short topic, count = 0;
 
-    /* Select randomly based on frequency weight */
-    unsigned short randomVal     = RandomGen() % totalWeight;
-    unsigned short currentWeight = 0;
+    for (topic = 0; topic < kMarkovTopicCount; topic++) {
+        if (gTopicChains[topic] != NULL)
+            count++;
+    }
+    return count;
+}
 
-    for (i = 0; i < node->followerCount; i++) {
-        currentWeight += node->followers[i].frequency;
-        if (randomVal < currentWeight) {
-            return i;
+/* Get a topic sub-model, loading it from the application's resources if it isn't loaded yet.
+ * Returns NULL if it can't be, such as when the heap is short even with other topics unloaded */
+static MarkovChain *LoadTopic(MarkovTopic topic)
+{
+    MarkovChain *chain = NULL;
+    Handle model;
+    short maxNodes;
+    long size;
+    Ptr storage;
+
+    if (gTopicChains[topic] != NULL || gTopicWords == 0)
+        return gTopicChains[topic];
+
+    while (LoadedTopics() >= kMaxTopics && UnloadStaleTopic())
+        ;
+
+    model = GetResource(MARKOV_MODEL_RES_TYPE, MARKOV_MODEL_RES_ID + topic);
+    if (model == NULL)
+        return NULL;
+
+    /* Sub-models don't learn, so they get just the room their model needs */
+    HLock(model);
+    maxNodes = MarkovChain_ModelCapacity((const unsigned char *)*model, GetHandleSize(model));
+    size     = MarkovChain_SharedStorageSize(maxNodes, gMarkovChain->dictionary->maxWords);
+    while (maxNodes > 0 && FreeMem() - size < kMarkovHeapReserve && UnloadStaleTopic())
+        ;
+
+    if (maxNodes > 0 && FreeMem() - size >= kMarkovHeapReserve &&
+        (storage = NewPtr(size)) != NULL) {
+        chain = MarkovChain_InitShared(storage, maxNodes, gMarkovChain->dictionary);
+        if (MarkovChain_Load(chain, (const unsigned char *)*model, GetHandleSize(model))) {
+            MarkovChain_SetSampling(chain, gMarkovTemperature, gMarkovTopK);
+            gTopicChains[topic] = chain;
+        }
+        else {
+            DisposePtr(storage);
+            chain = NULL;
         }
     }
+    HUnlock(model);
+    ReleaseResource(model);
 
-    /* Fallback (shouldn't happen) */
-    return RandomGen() % node->followerCount;
+    return chain;
 }
 
-/* Extract second word from a state */
-static void GetSecondWord(const char *state, char *word)
+/* Mix the topic sub-models the prompt is about with the general chain, which comes last so a
+ * relevant start is looked for in the topics first. Topics share their part by keyword count */
+static void MixTopics(MarkovMixture *mixture, const TokenList *prompt)
 {
-    const char *space = strchr(state, ' ');
-    if (space) {
-        strcpy(word, space + 1);
+    MarkovTopic topics[kMaxTopics];
+    short hits[kMaxTopics];
+    short count = 0, totalHits = 0, generalWeight = 100, weight, i;
+    MarkovChain *chain;
+
+    MarkovMixture_Init(mixture);
+    if (gTopicWords > 0 && prompt != NULL)
+        count = MarkovTopic_Route(prompt, topics, hits, kMaxTopics);
+
+    /* Routed topics are marked used first, so loading one never unloads another */
+    gTopicReplies++;
+    for (i = 0; i < count; i++) {
+        gTopicUsed[topics[i]] = gTopicReplies;
+        totalHits += hits[i];
     }
-    else {
-        /* Fallback if no space found */
-        strcpy(word, state);
+
+    for (i = 0; i < count; i++) {
+        chain = LoadTopic(topics[i]);
+        if (chain == NULL)
+            continue;
+        weight = kTopicMixPercent * hits[i] / totalHits;
+        MarkovMixture_Add(mixture, chain, weight);
+        generalWeight -= weight;
     }
+    MarkovMixture_Add(mixture, gMarkovChain, generalWeight);
 }
 
-/* Generate a Markov chain response text */
-static void GenerateMarkovText(char *response, short maxLength)
+/* Initialize the Markov chain with data from markov_data.c */
+static void InitMarkovChain(void)
 {
-    char current_state[MAX_STATE_LENGTH];
-    char next_word[MAX_WORD_LENGTH];
-    char next_state[MAX_STATE_LENGTH];
-    short stateIndex, followerIndex;
-    short wordCount      = 0;
-    short sentenceCount  = 0;
-    short sentenceTarget = (RandomGen() % 2) + 1; /* 1-2 sentences */
-
-    /* Start with a random state from the chain */
-    if (gMarkovNodeCount == 0) {
-        strcpy(response, "I don't have enough information yet.");
+    gMarkovChainDirty = FALSE;
+    gMarkovFactCount  = 0;
+
+    /* The sub-models refer to the words of the dictionary about to be replaced */
+    UnloadTopics();
+
+    /* The static corpus is trained at build time; only system facts are added at runtime. A
+     * chain saved by an earlier session already holds the corpus plus what it learned */
+    if (LoadSavedChain() || LoadPrecompiledModel()) {
+        /* The precompiled model's words keep their IDs in a saved chain, as they are held here
+         * for the sub-models whether those are loaded or not */
+        gTopicWords = PrecompiledModelWords();
+        MarkovChain_HoldWords(gMarkovChain, gTopicWords);
+        gTrainingCursor = StaticTrainingCount();
         return;
     }
 
-    /* Clear the response */
-    response[0] = '\0';
-
-    /* Pick a starter state (preferably one that starts a sentence) */
-    short attempts = 0;
-    do {
-        stateIndex = RandomGen() % gMarkovNodeCount;
-        attempts++;
-    } while (!gMarkovChain[stateIndex].isStartOfSentence && attempts < 20);
-
-    /* Add the starting state to the response */
-    strcpy(current_state, gMarkovChain[stateIndex].state);
-    strcat(response, current_state);
-    wordCount += 2; /* State has two words */
-
-    /* Generate the response */
-    while (strlen(response) < maxLength - MAX_WORD_LENGTH && sentenceCount < sentenceTarget) {
-        /* Try to find the current state in the chain */
-        stateIndex = FindStateInChain(current_state);
-
-        if (stateIndex < 0 || gMarkovChain[stateIndex].followerCount == 0) {
-            /* State not found or has no followers */
-            strcat(response, ". "); /* End the sentence */
-            sentenceCount++;
-
-            /* Pick a new sentence starter state */
-            do {
-                stateIndex = RandomGen() % gMarkovNodeCount;
-            } while (!gMarkovChain[stateIndex].isStartOfSentence && attempts < 10);
-
-            strcpy(current_state, gMarkovChain[stateIndex].state);
-            strcat(response, current_state);
-            wordCount += 2;
-        }
-        else {
-            /* Select a follower using weighted selection */
-            followerIndex = SelectWeightedFollower(&gMarkovChain[stateIndex]);
-            if (followerIndex < 0)
-                continue;
-
-            strcpy(next_word, gMarkovChain[stateIndex].followers[followerIndex].word);
-
-            /* Add space and the next word */
-            strcat(response, " ");
-            strcat(response, next_word);
-            wordCount++;
-
-            /* Create the next state */
-            char second_word[MAX_WORD_LENGTH];
-            GetSecondWord(current_state, second_word);
-            MakeState(second_word, next_word, next_state);
-            strcpy(current_state, next_state);
-
-            /* Check for end of sentence */
-            size_t len = strlen(next_word);
-            if (len > 0 && IsSentenceEnder(next_word[len - 1])) {
-                sentenceCount++;
-                if (sentenceCount < sentenceTarget) {
-                    strcat(response, " ");
-                }
-            }
-        }
+    /* No usable precompiled model, so train everything. That takes seconds on a 68000, so it
+     * is done a slice at a time from the event loop while replies use what is there so far.
+     * The sub-models were built on the precompiled dictionary, so replies use this chain alone */
+    MarkovChain_Reset(gMarkovChain);
+    gTopicWords     = 0;
+    gTrainingCursor = 0;
+}
 
-        /* Avoid exceptionally long sentences */
-        if (wordCount > 20 && sentenceCount < sentenceTarget) {
-            short i = strlen(response) - 1;
-            while (i > 0 && !strchr(".!?", response[i]))
-                i--;
-
-            if (i < strlen(response) - 15) { /* If no recent sentence ending */
-                strcat(response, ". ");
-                sentenceCount++;
-
-                /* Pick a new sentence starter state */
-                do {
-                    stateIndex = RandomGen() % gMarkovNodeCount;
-                } while (!gMarkovChain[stateIndex].isStartOfSentence && attempts < 10);
-
-                strcpy(current_state, gMarkovChain[stateIndex].state);
-                strcat(response, current_state);
-                wordCount += 2;
-            }
-        }
+/* Train the next slice of whatever the chain still lacks */
+void TrainMarkovIdle(void)
+{
+    if (gMarkovChain == NULL)
+        return;
+
+    if (gTrainingCursor == kTrainingDone) {
+        /* Keep the clock, uptime and free memory facts current */
+        if (TickCount() - gMarkovFactTicks >= kFactRefreshTicks)
+            RefreshMarkovFacts();
+        return;
     }
 
-    /* Ensure the response ends with proper punctuation */
-    size_t len = strlen(response);
-    if (len > 0 && !strchr(".!?", response[len - 1])) {
-        strcat(response, ".");
+    if (gTrainingCursor < StaticTrainingCount()) {
+        gTrainingCursor = LoadStaticTrainingSlice(gTrainingCursor, kTrainingSliceEntries);
+        return;
     }
+
+    /* The system facts are few; they and the switch to learning finish the chain */
+    RefreshMarkovFacts();
+    MarkovChain_SetEviction(gMarkovChain, gMarkovLearning);
+    gTrainingCursor = kTrainingDone;
 }
 
-/* Initialize the Markov model */
-void InitMarkovModel(void)
+/* Check whether the chain has all of its training */
+Boolean IsMarkovReady(void)
+{
+    return gMarkovChain != NULL && gTrainingCursor == kTrainingDone;
+}
+
+/* Get how full the chain is and the shape of its contents */
+void GetMarkovStats(MarkovChainStats *stats)
 {
-    /* Initialize random number generator */
-    InitRandom();
+    if (gMarkovChain != NULL)
+        MarkovChain_GetStats(gMarkovChain, stats);
+    else
+        memset(stats, 0, sizeof(*stats));
+}
 
-    /* Initialize the Markov chain with training data */
-    InitMarkovChain();
+#ifdef DEBUG
+/* Percentage of a whole, 0 if there is none */
+static long Percent(long part, long whole)
+{
+    return (whole > 0) ? part * 100 / whole : 0;
 }
 
-/* Check if a state contains a keyword */
-static Boolean ContainsKeyword(const char *state, const char *keyword)
+/* Describe the chain's statistics in a few sentences, to read in the chat window */
+char *DescribeMarkovStats(void)
 {
-    char stateLower[MAX_STATE_LENGTH];
-    char keywordLower[MAX_WORD_LENGTH];
-    char *wordPtr;
+    static char description[kMarkovReplyLength];
+    char line[160];
+    unsigned long probes;
+    MarkovChainStats stats;
+    TextBuilder builder;
     short i;
 
-    /* Convert state to lowercase for case-insensitive matching */
-    for (i = 0; state[i]; i++) {
-        stateLower[i] = (state[i] >= 'A' && state[i] <= 'Z') ? state[i] + 32 : state[i];
-    }
-    stateLower[i] = '\0';
+    GetMarkovStats(&stats);
+    TextBuilder_Init(&builder, description, sizeof(description));
 
-    /* Convert keyword to lowercase */
-    for (i = 0; keyword[i]; i++) {
-        keywordLower[i] = (keyword[i] >= 'A' && keyword[i] <= 'Z') ? keyword[i] + 32 : keyword[i];
-    }
-    keywordLower[i] = '\0';
-
-    /* Check if keyword is in state */
-    return (strstr(stateLower, keywordLower) != NULL);
-}
-
-/* Find a good starting state based on user query keywords */
-static short FindRelevantStartingState(const char *userMessage)
-{
-    short i, bestIndex = -1;
-    short relevanceScore = 0;
-    short bestScore      = 0;
-    char keyword[MAX_WORD_LENGTH];
-    char *msgCopy, *token;
-    const char *keywords[] = {"science",  "computer", "mac",     "help",  "what",
-                              "how",      "why",      "health",  "time",  "digital",
-                              "creative", "learn",    "think",   "music", "art",
-                              "history",  "code",     "program", "system"};
-    short keywordCount     = sizeof(keywords) / sizeof(keywords[0]);
-    short attempts         = 0;
-
-    /* If no user message or very short, just return a random state */
-    if (!userMessage || strlen(userMessage) < 4) {
-        goto use_random_state;
+    sprintf(line, "Contexts: %d of %d (%ld%%), %d start a sentence (%ld%%), by order",
+            stats.nodeCount, stats.maxNodes, Percent(stats.nodeCount, stats.maxNodes),
+            stats.startNodes, Percent(stats.startNodes, stats.nodeCount));
+    TextBuilder_Append(&builder, line);
+    for (i = 0; i < MARKOV_ORDER; i++) {
+        sprintf(line, " %d", stats.nodesByOrder[i]);
+        TextBuilder_Append(&builder, line);
     }
 
-    /* Make a copy of the user message that we can modify */
-    msgCopy = (char *)NewPtr(strlen(userMessage) + 1);
-    if (!msgCopy) {
-        goto use_random_state;
-    }
-    strcpy(msgCopy, userMessage);
-
-    /* First check for exact matches with the predefined keywords */
-    for (i = 0; i < keywordCount; i++) {
-        if (strstr(msgCopy, keywords[i]) != NULL) {
-            /* Search for states containing this keyword */
-            short j;
-            for (j = 0; j < gMarkovNodeCount; j++) {
-                if (ContainsKeyword(gMarkovChain[j].state, keywords[i]) &&
-                    gMarkovChain[j].isStartOfSentence) {
-                    /* Found a relevant starter state */
-                    bestIndex = j;
-                    DisposePtr(msgCopy);
-                    return bestIndex;
-                }
-            }
-        }
+    sprintf(line, ". Followers: %ld, at most %d; %d contexts full, %ld counts at the limit, "
+                  "%u halvings. By follower count",
+            stats.followers, stats.mostFollowers, stats.saturatedNodes, stats.saturatedCounts,
+            stats.countHalvings);
+    TextBuilder_Append(&builder, line);
+    for (i = 0; i < kMarkovFollowerBuckets; i++) {
+        sprintf(line, " %d:%d", (i > 0) ? 1 << (i - 1) : 0, stats.followerHistogram[i]);
+        TextBuilder_Append(&builder, line);
     }
 
-    /* If no match with predefined keywords, try to use the user's own words */
-    token = strtok(msgCopy, " ,.!?");
-    while (token != NULL) {
-        /* Skip very short words and common words */
-        if (strlen(token) >= 4 && strcmp(token, "this") != 0 && strcmp(token, "that") != 0 &&
-            strcmp(token, "with") != 0 && strcmp(token, "from") != 0 &&
-            strcmp(token, "what") != 0 && strcmp(token, "when") != 0 &&
-            strcmp(token, "where") != 0 && strcmp(token, "which") != 0 &&
-            strcmp(token, "have") != 0 && strcmp(token, "your") != 0) {
-
-            /* Look for states containing this word */
-            short j;
-            for (j = 0; j < gMarkovNodeCount; j++) {
-                if (ContainsKeyword(gMarkovChain[j].state, token)) {
-                    relevanceScore = 1;
-                    /* Prefer sentence starters with higher follower counts */
-                    if (gMarkovChain[j].isStartOfSentence) {
-                        relevanceScore += 2;
-                    }
-                    if (gMarkovChain[j].followerCount > 2) {
-                        relevanceScore += 1;
-                    }
-
-                    if (relevanceScore > bestScore) {
-                        bestScore = relevanceScore;
-                        bestIndex = j;
-                    }
-                }
-            }
-        }
-        token = strtok(NULL, " ,.!?");
-    }
+    sprintf(line, ". Pool: %u of %u (%ld%%), %u prunes. Words: %d of %d, %u of %u characters. ",
+            stats.poolUsed, stats.poolSize, Percent(stats.poolUsed, stats.poolSize),
+            stats.poolPrunes, stats.wordCount, stats.maxWords, stats.wordChars,
+            stats.maxWordChars);
+    TextBuilder_Append(&builder, line);
+
+    /* Probes per lookup in hundredths, as there is no floating point to spare */
+    probes = (stats.lookup.lookups > 0) ? stats.lookup.probes * 100 / stats.lookup.lookups : 0;
+    sprintf(line,
+            "Memory: %ld bytes, %u evictions. Lookups: %lu, %lu.%02lu probes each, at most %u.",
+            stats.memoryBytes, stats.evictions, stats.lookup.lookups, probes / 100, probes % 100,
+            stats.lookup.maxProbes);
+    TextBuilder_Append(&builder, line);
+    return description;
+}
+
+/* Describe the reply settings, after a debug command changes them */
+char *DescribeMarkovSettings(void)
+{
+    static char description[kMaxPromptLength];
+
+    sprintf(description, "Sampling at %d%% temperature, top-k %d; best of %d candidates, "
+                         "beam width %d.",
+            gMarkovTemperature, gMarkovTopK, gMarkovCandidates, gMarkovBeamWidth);
+    return description;
+}
+#endif
+
+/* Set how adventurous generated text is, for the loaded chains and any loaded later */
+void SetMarkovSampling(short temperature, short topK)
+{
+    short topic;
 
-    DisposePtr(msgCopy);
+    gMarkovTemperature = (temperature > 0) ? temperature : 1;
+    gMarkovTopK        = (topK > 0) ? topK : 0;
 
-    /* If we found a relevant state, use it */
-    if (bestIndex >= 0) {
-        return bestIndex;
+    if (gMarkovChain != NULL)
+        MarkovChain_SetSampling(gMarkovChain, gMarkovTemperature, gMarkovTopK);
+    for (topic = 0; topic < kMarkovTopicCount; topic++) {
+        if (gTopicChains[topic] != NULL)
+            MarkovChain_SetSampling(gTopicChains[topic], gMarkovTemperature, gMarkovTopK);
     }
+}
 
-use_random_state:
-    /* Fallback to random sentence starter state */
-    do {
-        bestIndex = RandomGen() % gMarkovNodeCount;
-        attempts++;
-    } while (!gMarkovChain[bestIndex].isStartOfSentence && attempts < 20);
+/* Bytes the chain may use: a share of the free heap, capped on machines with little RAM */
+static long MarkovChainBudget(void)
+{
+    long budget = (FreeMem() - kMarkovHeapReserve) / 100 * MARKOV_HEAP_PERCENT;
+    long physicalRAM;
 
-    return bestIndex;
+    if (Gestalt(gestaltPhysicalRAMSize, &physicalRAM) == noErr &&
+        budget > physicalRAM / kMarkovRAMShare)
+        budget = physicalRAM / kMarkovRAMShare;
+    return budget;
 }
 
-/* Generate a Markov chain response based on user input */
-static void GenerateContextualMarkovText(char *response, short maxLength, const char *userMessage)
+/* Smallest chain the precompiled model loads into, kMarkovMinNodes if there is none */
+static short PrecompiledModelCapacity(void)
 {
-    char current_state[MAX_STATE_LENGTH];
-    char next_word[MAX_WORD_LENGTH];
-    char next_state[MAX_STATE_LENGTH];
-    short stateIndex, followerIndex;
-    short wordCount      = 0;
-    short sentenceCount  = 0;
-    short sentenceTarget = (RandomGen() % 2) + 1; /* 1-2 sentences */
+    short capacity;
+    Handle model;
 
-    /* Start with a state related to the user query if possible */
-    if (gMarkovNodeCount == 0) {
-        strcpy(response, "I don't have enough information yet.");
-        return;
-    }
+    model = GetResource(MARKOV_MODEL_RES_TYPE, MARKOV_MODEL_RES_ID);
+    if (model == NULL)
+        return kMarkovMinNodes;
 
-    /* Clear the response */
-    response[0] = '\0';
-
-    /* Try to find a relevant starting state */
-    stateIndex = FindRelevantStartingState(userMessage);
-
-    /* Add the starting state to the response */
-    strcpy(current_state, gMarkovChain[stateIndex].state);
-    strcat(response, current_state);
-    wordCount += 2; /* State has two words */
-
-    /* Generate the response - same as before */
-    while (strlen(response) < maxLength - MAX_WORD_LENGTH && sentenceCount < sentenceTarget) {
-        /* Try to find the current state in the chain */
-        stateIndex = FindStateInChain(current_state);
-
-        if (stateIndex < 0 || gMarkovChain[stateIndex].followerCount == 0) {
-            /* State not found or has no followers */
-            strcat(response, ". "); /* End the sentence */
-            sentenceCount++;
-
-            /* Pick a new sentence starter state */
-            short attempts = 0;
-            do {
-                stateIndex = RandomGen() % gMarkovNodeCount;
-                attempts++;
-            } while (!gMarkovChain[stateIndex].isStartOfSentence && attempts < 10);
-
-            strcpy(current_state, gMarkovChain[stateIndex].state);
-            strcat(response, current_state);
-            wordCount += 2;
-        }
-        else {
-            /* Select a follower using weighted selection */
-            followerIndex = SelectWeightedFollower(&gMarkovChain[stateIndex]);
-            if (followerIndex < 0)
-                continue;
-
-            strcpy(next_word, gMarkovChain[stateIndex].followers[followerIndex].word);
-
-            /* Add space and the next word */
-            strcat(response, " ");
-            strcat(response, next_word);
-            wordCount++;
-
-            /* Create the next state */
-            char second_word[MAX_WORD_LENGTH];
-            GetSecondWord(current_state, second_word);
-            MakeState(second_word, next_word, next_state);
-            strcpy(current_state, next_state);
-
-            /* Check for end of sentence */
-            size_t len = strlen(next_word);
-            if (len > 0 && IsSentenceEnder(next_word[len - 1])) {
-                sentenceCount++;
-                if (sentenceCount < sentenceTarget) {
-                    strcat(response, " ");
-                }
-            }
-        }
+    HLock(model);
+    capacity = MarkovChain_ModelCapacity((const unsigned char *)*model, GetHandleSize(model));
+    HUnlock(model);
+    ReleaseResource(model);
 
-        /* Avoid exceptionally long sentences */
-        if (wordCount > 20 && sentenceCount < sentenceTarget) {
-            short i = strlen(response) - 1;
-            while (i > 0 && !strchr(".!?", response[i]))
-                i--;
-
-            if (i < strlen(response) - 15) { /* If no recent sentence ending */
-                strcat(response, ". ");
-                sentenceCount++;
-
-                /* Pick a new sentence starter state */
-                short attempts = 0;
-                do {
-                    stateIndex = RandomGen() % gMarkovNodeCount;
-                    attempts++;
-                } while (!gMarkovChain[stateIndex].isStartOfSentence && attempts < 10);
-
-                strcpy(current_state, gMarkovChain[stateIndex].state);
-                strcat(response, current_state);
-                wordCount += 2;
-            }
-        }
-    }
+    return (capacity > 0) ? capacity : kMarkovMinNodes;
+}
 
-    /* Ensure the response ends with proper punctuation */
-    size_t len = strlen(response);
-    if (len > 0 && !strchr(".!?", response[len - 1])) {
-        strcat(response, ".");
+/* Allocate the largest chain the budget allows, smaller if the heap is fragmented, but never
+ * too small for the precompiled model. A chain it doesn't fit would retrain the corpus for
+ * seconds at every start, with no sub-models, so there is no chain instead and replies say how
+ * much more memory it needs */
+static MarkovChain *NewMarkovChain(void)
+{
+    long budget    = MarkovChainBudget();
+    short minNodes = PrecompiledModelCapacity();
+    short maxNodes;
+    Ptr storage;
+
+    gMarkovShortfall = MarkovChain_StorageSize(minNodes) + kMarkovHeapReserve - FreeMem();
+    if (gMarkovShortfall > 0)
+        return NULL;
+    gMarkovShortfall = 0;
+
+    for (maxNodes = kMarkovMaxNodes;
+         maxNodes > minNodes && MarkovChain_StorageSize(maxNodes) > budget;
+         maxNodes -= kChainSizeStep)
+        ;
+
+    /* The budget comes from FreeMem, but the chain needs one contiguous block */
+    for (;;) {
+        if (maxNodes < minNodes)
+            maxNodes = minNodes;
+        storage = NewPtr(MarkovChain_StorageSize(maxNodes));
+        if (storage != NULL)
+            return MarkovChain_Init(storage, maxNodes);
+        if (maxNodes == minNodes)
+            return NULL;
+        maxNodes -= kChainSizeStep;
     }
 }
 
+/* Initialize the Markov model */
+void InitMarkovModel(void)
+{
+    /* Seeded once, so switching models back and forth doesn't replay the same replies */
+    if (gRandom.state == 0)
+        Random_Seed(&gRandom, Random_SessionSeed(), kRandomStreamMarkov);
+
+    if (gMarkovChain == NULL)
+        gMarkovChain = NewMarkovChain();
+    if (gMarkovChain == NULL)
+        return; /* Replies say there isn't enough memory */
+
+    /* Load the chain; whatever it lacks is trained from the event loop */
+    InitMarkovChain();
+    MarkovChain_SetSampling(gMarkovChain, gMarkovTemperature, gMarkovTopK);
+}
+
+/* Give the chain's memory back once another model is active */
+void ReleaseMarkovModel(void)
+{
+    if (gMarkovChain == NULL)
+        return;
+
+    /* Keep what was learned for when the model is selected again */
+    SaveMarkovChain();
+    UnloadTopics();
+    DisposePtr((Ptr)gMarkovChain);
+    gMarkovChain    = NULL;
+    gTrainingCursor = kTrainingDone;
+}
+
+/* Set how many candidates each reply is picked from, 1 for a single random walk */
+void SetMarkovCandidates(short count)
+{
+    if (count < 1)
+        count = 1;
+    if (count > kMaxCandidates)
+        count = kMaxCandidates;
+    gMarkovCandidates = count;
+}
+
+/* Set the beam width for decoding replies, 1 to sample them */
+void SetMarkovBeamWidth(short width)
+{
+    if (width < 1)
+        width = 1;
+    if (width > kMaxBeamWidth)
+        width = kMaxBeamWidth;
+    gMarkovBeamWidth = width;
+}
+
 /* Function that returns an appropriate response based on user input using Markov model */
-char *GenerateMarkovResponse(const ConversationHistory *history)
-{
-    static char response[512];
-    const char *userMessage = NULL;
-
-    /* Initialize with default response in case something goes wrong */
-    strcpy(response, "I'm thinking about how to respond...");
-
-    if (history != NULL && history->count > 0) {
-        /* Find the last user message */
-        short i;
-        for (i = history->count - 1; i >= 0; i--) {
-            if (history->messages[i].type == kUserMessage) {
-                userMessage = history->messages[i].text;
-                break;
-            }
+char *GenerateMarkovResponse(const TokenList *prompt)
+{
+    static char message[kMaxPromptLength];
+    MarkovMixture mixture;
+    char *reply;
+
+    if (gMarkovChain == NULL) {
+        if (gMarkovShortfall > 0) {
+            sprintf(message,
+                    "The Markov chain needs %ldK more memory. Quit and give the application "
+                    "more memory in its Get Info window.",
+                    (gMarkovShortfall + 1023) / 1024);
         }
-
-        if (userMessage && *userMessage) {
-            /* Generate contextual response based on markov chain */
-            GenerateContextualMarkovText(response, 500, userMessage);
-            return response;
+        else {
+            strcpy(message, "There isn't enough memory for the Markov chain.");
         }
+        return message;
     }
+    if (MarkovChain_FindState(gMarkovChain, -1, kSentenceStart) < 0) {
+        /* Nothing has been trained, so no sentence can start */
+        strcpy(message, "I don't have enough information yet.");
+        return message;
+    }
+
+    MixTopics(&mixture, (prompt != NULL && prompt->count > 0) ? prompt : NULL);
+    reply = MarkovReply_Generate(&mixture, prompt, gMarkovCandidates, gMarkovBeamWidth, &gRandom);
 
-    /* No history or no user message, generate generic response */
-    GenerateMarkovText(response, 500);
-    return response;
+    /* Out of time before the first word */
+    if (reply[0] == '\0')
+        strcpy(reply, "Let me think about that some more.");
+    return reply;
 }
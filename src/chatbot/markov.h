@@ -2,6 +2,7 @@
 #define MARKOV_H
 
 #include "../constants.h"
+#include "markov_chain.h"
 
 /* Maximum number of conversation turns we'll track */
 #define kMaxConversationHistory 50
@@ -26,13 +27,67 @@ typedef struct {
 /* Train the Markov chain with new text */
 void TrainMarkov(const char *text);
 
+/* Train the Markov chain on a volatile fact, such as the time or free memory. The facts are
+ * refreshed on a timer: the old ones are untrained and current ones trained in their place */
+void TrainMarkovFact(const char *text);
+
+/* Turn learning from user prompts on or off. While on, the chain forgets the least recently
+ * used contexts when full, so memory stays bounded however long the conversation runs */
+void SetMarkovLearning(Boolean enabled);
+
+/* Check whether the Markov chain learns from user prompts */
+Boolean IsMarkovLearning(void);
+
+/* Train the Markov chain on a user prompt if learning is on */
+void LearnMarkovPrompt(const TokenList *prompt);
+
+/* Save the Markov chain to the Preferences folder if learning changed it, so the next launch
+ * starts from it */
+void SaveMarkovChain(void);
+
 /* Load the training data for the Markov model */
 void LoadTrainingData(void);
 
-/* Initialize the Markov model */
+/* Initialize the Markov model, allocating a chain as large as free memory allows. Returns
+ * quickly; anything the chain still has to train is done by TrainMarkovIdle */
 void InitMarkovModel(void);
 
-/* Interface for Markov model interaction */
-char *GenerateMarkovResponse(const ConversationHistory *history);
+/* Train the next small slice of the corpus the chain lacks, from the event loop */
+void TrainMarkovIdle(void);
+
+/* Check whether the chain has all of its training. Replies work before then, from whatever
+ * has been trained so far */
+Boolean IsMarkovReady(void);
+
+/* Save the chain if it learned anything and free its memory, when another model is selected */
+void ReleaseMarkovModel(void);
+
+/* Reply to the user's last message, split into tokens, or to nothing if prompt is NULL */
+char *GenerateMarkovResponse(const TokenList *prompt);
+
+/* Set the sampling temperature (percent, 100 is as trained) and top-k (0 for all followers).
+ * The defaults are MARKOV_TEMPERATURE and MARKOV_TOP_K */
+void SetMarkovSampling(short temperature, short topK);
+
+/* Set how many candidate replies to generate and pick the best of, by how many prompt words
+ * each uses and how likely the chain finds it. 1 gives a single random walk; fewer candidates
+ * are made if the reply budget runs out first */
+void SetMarkovCandidates(short count);
+
+/* Set the beam width: above 1, each sentence is decoded as the most likely of that many partial
+ * sentences instead of sampled word by word. The partial sentences grow by sampled followers,
+ * so replies still vary. The default is MARKOV_BEAM_WIDTH */
+void SetMarkovBeamWidth(short width);
+
+/* Get how full the chain is and the shape of its contents, all zero if there is no chain */
+void GetMarkovStats(MarkovChainStats *stats);
+
+#ifdef DEBUG
+/* Describe the chain's statistics in a few sentences, for capacity tuning */
+char *DescribeMarkovStats(void);
+
+/* Describe the reply settings in a sentence, after a debug command changes them */
+char *DescribeMarkovSettings(void);
+#endif
 
 #endif /* MARKOV_H */
\ No newline at end of file
@@ -0,0 +1,169 @@
+#include <string.h>
+
+#include "markov_beam.h"
+
+/* Whether a ranks above b once their lengths are allowed for. Cross-multiplied rather than
+ * divided, as a 68000 has no 32-bit divide; the products stay well within a long */
+static Boolean BeamBetter(const MarkovBeamHypothesis *a, const MarkovBeamHypothesis *b,
+                          short lengthPenalty)
+{
+    long scaleA = 100 + (long)lengthPenalty * (a->length > 1 ? a->length - 1 : 0);
+    long scaleB = 100 + (long)lengthPenalty * (b->length > 1 ? b->length - 1 : 0);
+
+    return a->logProb * scaleB > b->logProb * scaleA;
+}
+
+/* Insert a hypothesis into a set kept best first, if it ranks among the width best */
+static void KeepHypothesis(MarkovBeamHypothesis *set, short *count, short width,
+                           const MarkovBeamHypothesis *hypothesis, short lengthPenalty)
+{
+    short i = *count;
+
+    if (i == width) {
+        if (!BeamBetter(hypothesis, &set[width - 1], lengthPenalty))
+            return;
+        i--; /* The worst makes way */
+    }
+    else {
+        (*count)++;
+    }
+
+    while (i > 0 && BeamBetter(hypothesis, &set[i - 1], lengthPenalty)) {
+        set[i] = set[i - 1];
+        i--;
+    }
+    set[i] = *hypothesis;
+}
+
+/* Add a word to a hypothesis as its newest */
+static void ExtendHypothesis(MarkovBeamHypothesis *hypothesis, WordID word, short logProb)
+{
+    short i;
+
+    hypothesis->logProb += logProb;
+    hypothesis->length++;
+    hypothesis->ended       = (word == kSentenceEnd);
+    hypothesis->extended    = TRUE;
+    hypothesis->word        = word;
+    hypothesis->wordLogProb = logProb;
+
+    if (hypothesis->recentCount < MARKOV_MAX_ORDER)
+        hypothesis->recentCount++;
+    for (i = hypothesis->recentCount - 1; i > 0; i--) {
+        hypothesis->recentWords[i] = hypothesis->recentWords[i - 1];
+    }
+    hypothesis->recentWords[0] = word;
+}
+
+/* Draw up to max distinct followers of a hypothesis by their probability, returns how many */
+static short SampleFollowers(MarkovMixture *mixture, const MarkovBeamHypothesis *hypothesis,
+                             short max, RandomStream *random, WordID *words, short *logProbs)
+{
+    short found = 0, draw, logProb, i;
+    WordID word;
+
+    for (draw = 0; draw < max; draw++) {
+        word = MarkovMixture_SampleFollower(mixture, hypothesis->recentWords,
+                                            hypothesis->recentCount, random, &logProb);
+        if (word == kNoWord)
+            return 0;
+
+        /* Likely followers come up more than once, which leaves fewer to rank */
+        for (i = 0; i < found && words[i] != word; i++)
+            ;
+        if (i == found) {
+            words[found]      = word;
+            logProbs[found++] = logProb;
+        }
+    }
+    return found;
+}
+
+/* Decode the most likely sentence continuing the recent words */
+short MarkovBeam_Decode(MarkovMixture *mixture, MarkovBeamPool *pool, const WordID *recentWords,
+                        short recentCount, short width, short lengthPenalty, RandomStream *random,
+                        WordID *words, short *logProbs)
+{
+    MarkovBeamHypothesis *current = pool->beams[0];
+    MarkovBeamHypothesis *next    = pool->beams[1];
+    MarkovBeamHypothesis *swap, extension;
+    WordID followers[kMaxBeamWidth];
+    short followerLogProbs[kMaxBeamWidth];
+    short currentCount = 1, nextCount, wordsUsed = 0;
+    short step, found, length, i, j;
+
+    if (width < 1)
+        width = 1;
+    if (width > kMaxBeamWidth)
+        width = kMaxBeamWidth;
+    if (recentCount > MARKOV_MAX_ORDER)
+        recentCount = MARKOV_MAX_ORDER;
+
+    memset(&current[0], 0, sizeof(MarkovBeamHypothesis));
+    memcpy(current[0].recentWords, recentWords, recentCount * sizeof(WordID));
+    current[0].recentCount = recentCount;
+    current[0].last        = -1;
+
+    for (step = 0; step < kMaxBeamWords; step++) {
+        /* Finished hypotheses compete with the growing ones for the next step's places. Only
+         * the best width followers of each can make it, so only those are looked at */
+        nextCount = 0;
+        for (i = 0; i < currentCount; i++) {
+            extension          = current[i];
+            extension.extended = FALSE;
+            if (extension.ended) {
+                KeepHypothesis(next, &nextCount, width, &extension, lengthPenalty);
+                continue;
+            }
+
+            if (random != NULL)
+                found = SampleFollowers(mixture, &extension, width, random, followers,
+                                        followerLogProbs);
+            else
+                found = MarkovMixture_LikelyFollowers(mixture, extension.recentWords,
+                                                      extension.recentCount, width, followers,
+                                                      followerLogProbs);
+            if (found == 0 && extension.length > 0) {
+                extension.ended = TRUE; /* Dead end, the sentence stops here */
+                KeepHypothesis(next, &nextCount, width, &extension, lengthPenalty);
+            }
+
+            for (j = 0; j < found; j++) {
+                extension = current[i];
+                ExtendHypothesis(&extension, followers[j], followerLogProbs[j]);
+                KeepHypothesis(next, &nextCount, width, &extension, lengthPenalty);
+            }
+        }
+        if (nextCount == 0)
+            return 0; /* The recent words have no followers at all */
+
+        /* Record the words of the survivors that grew; each step adds at most width */
+        for (i = 0; i < nextCount; i++) {
+            if (!next[i].extended)
+                continue;
+            pool->words[wordsUsed].word     = next[i].word;
+            pool->words[wordsUsed].logProb  = next[i].wordLogProb;
+            pool->words[wordsUsed].previous = next[i].last;
+            next[i].last                    = wordsUsed++;
+        }
+
+        swap         = current;
+        current      = next;
+        next         = swap;
+        currentCount = nextCount;
+
+        for (i = 0; i < currentCount && current[i].ended; i++)
+            ;
+        if (i == currentCount)
+            break; /* Every hypothesis is finished */
+    }
+
+    /* The best hypothesis comes first; follow its words back to the start */
+    length = current[0].length;
+    for (i = current[0].last, j = length; i >= 0; i = pool->words[i].previous) {
+        j--;
+        words[j]    = pool->words[i].word;
+        logProbs[j] = pool->words[i].logProb;
+    }
+    return length;
+}
@@ -0,0 +1,50 @@
+#ifndef MARKOV_BEAM_H
+#define MARKOV_BEAM_H
+
+#include "markov_mixture.h"
+#include "random.h"
+
+/* Beam search over a mixture of chains: keeps the width most likely partial sentences at each
+ * step instead of one random walk. Log probabilities are fixed point, as from the chain */
+#define kMaxBeamWidth kMaxMixtureFollowers /* Widest beam the pool has room for */
+#define kMaxBeamWords 24                   /* Longest sentence decoded at once; cut here */
+
+/* A partial sentence. Its words are a chain of MarkovBeamWords, newest first */
+typedef struct {
+    long logProb;                         /* Sum over its words, in kLogProbScale units */
+    short length;                         /* Words decoded */
+    short last;                           /* Newest word in the pool, -1 if none yet */
+    WordID recentWords[MARKOV_MAX_ORDER]; /* Newest first, for finding the next context */
+    short recentCount;
+    Boolean ended;    /* Reached a sentence end or a dead end */
+    Boolean extended; /* Grew this step; word is not in the pool yet */
+    WordID word;      /* Newest word while extended */
+    short wordLogProb;
+} MarkovBeamHypothesis;
+
+/* A decoded word, shared by every hypothesis grown from it */
+typedef struct {
+    WordID word;
+    short logProb;
+    short previous; /* Word before it in the pool, -1 at the start */
+} MarkovBeamWord;
+
+/* Everything a decode needs, allocated once by the caller so decoding allocates nothing */
+typedef struct {
+    MarkovBeamHypothesis beams[2][kMaxBeamWidth]; /* This step's and the next's */
+    MarkovBeamWord words[kMaxBeamWidth * kMaxBeamWords];
+} MarkovBeamPool;
+
+/* Decode the most likely sentence continuing the recent words (newest first). Hypotheses are
+ * ranked by log probability over 1 + lengthPenalty percent per word after the first: 0 ranks
+ * by total probability, which favors short sentences, and 100 by the mean per word. With random
+ * NULL each hypothesis grows by its width most likely followers, so the same words always
+ * decode the same sentence; otherwise by width followers drawn by probability, so likely
+ * sentences still win but repeated decodes differ. Fills words and logProbs, each with room for
+ * kMaxBeamWords, and returns the number of words, 0 if the recent words lead nowhere. A
+ * finished sentence's last word is kSentenceEnd */
+short MarkovBeam_Decode(MarkovMixture *mixture, MarkovBeamPool *pool, const WordID *recentWords,
+                        short recentCount, short width, short lengthPenalty, RandomStream *random,
+                        WordID *words, short *logProbs);
+
+#endif /* MARKOV_BEAM_H */
@@ -0,0 +1,2136 @@
+#include <math.h>
+#include <string.h>
+
+#include "markov_chain.h"
+
+/* Compact model format: big-endian header followed by the dictionary, saved only by the chain
+ * that owns it, and the nodes */
+#define MODEL_MAGIC 0x4D4B5631UL /* 'MKV1' */
+#define MODEL_VERSION 6
+#define MODEL_HEADER_SIZE 18 /* magic, version, count size and order, counts, text size, checksum */
+#define MODEL_NODE_SIZE 6    /* parent, word, flags and order, follower count */
+#define MODEL_COUNT_SIZE (MARKOV_COUNT_BITS / 8) /* Bytes per follower count */
+#define MODEL_FOLLOWER_SIZE (2 + MODEL_COUNT_SIZE)
+
+/* Flag bits stored with each node in the model format; the low bits hold the order */
+#define kModelNodeOrderMask 0x07
+
+/* The context every sentence starts from, which eviction and pruning must leave in place */
+#define IsSentenceRoot(node) ((node)->parent < 0 && (node)->word == kSentenceStart)
+
+/* Follower pool spans are preceded by a header entry naming their owner, or this once freed */
+#define kFreeFollowerSpan kNoWord
+#define kMinFollowerCapacity 2                  /* Room reserved for a context's first followers */
+#define kMinPruneGain(chain) ((chain)->followerPoolSize / 16) /* Least a prune should free */
+
+/* Contexts forgotten at most to fit one new word, and how many between dictionary scans. A
+ * flood of new vocabulary may not shrink the chain below kMinLearningNodes to make room */
+#define kMaxWordEvictions 32
+#define kWordEvictionBatch 8
+#define kMinLearningNodes(chain) ((chain)->maxNodes / 2)
+
+static short FindEvictionVictim(MarkovChain *chain, short keep);
+static void EvictState(MarkovChain *chain, short victim, short *keep);
+static long NeededNodes(long nodeCount, unsigned long entries, long wordCount, long textSize);
+static unsigned long LoadedPoolEntries(const MarkovChain *chain);
+
+/* Hash function for faster word lookup */
+static unsigned short HashString(const char *str)
+{
+    unsigned short hash = 0;
+    while (*str) {
+        hash = (hash * 31) + *str++;
+    }
+    return hash;
+}
+
+/* Text of a dictionary word */
+static const char *WordText(const MarkovDictionary *dict, WordID id)
+{
+    return &dict->wordText[dict->wordOffset[id]];
+}
+
+/* Get the text of an interned word */
+const char *MarkovChain_WordText(const MarkovChain *chain, WordID id)
+{
+    return WordText(chain->dictionary, id);
+}
+
+/* Find the hash slot holding a word, or the empty slot where it belongs */
+static short FindWordSlot(const MarkovDictionary *dict, const char *word)
+{
+    short slot = HashString(word) & dict->wordHashMask;
+
+    while (dict->wordHash[slot] != kNoWord &&
+           strcmp(WordText(dict, dict->wordHash[slot]), word) != 0) {
+        slot = (slot + 1) & dict->wordHashMask;
+    }
+    return slot;
+}
+
+/* Look up a word in a dictionary, returns its ID or kNoWord if unknown */
+static WordID FindWord(const MarkovDictionary *dict, const char *word)
+{
+    return dict->wordHash[FindWordSlot(dict, word)];
+}
+
+/* Look up a word in the dictionary, returns its ID or kNoWord if unknown */
+WordID MarkovChain_FindWord(const MarkovChain *chain, const char *word)
+{
+    return FindWord(chain->dictionary, word);
+}
+
+/* Make the lowercase, punctuation-free form of a word used for keyword matching */
+static void NormalizeWord(const char *word, char *normalized)
+{
+    short i;
+
+    for (i = 0; word[i] && i < MAX_WORD_LENGTH - 1; i++) {
+        normalized[i] = (word[i] >= 'A' && word[i] <= 'Z') ? word[i] + 32 : word[i];
+    }
+    normalized[i] = '\0';
+
+    /* Strip trailing punctuation so "Mac." and "mac" match the same keyword */
+    while (i > 1 && strchr(".,!?;:", normalized[i - 1])) {
+        normalized[--i] = '\0';
+    }
+}
+
+/* Look up the normalized (lowercase, unpunctuated) ID of a keyword */
+WordID MarkovChain_FindKeyword(const MarkovChain *chain, const char *keyword)
+{
+    char keywordLower[MAX_WORD_LENGTH];
+
+    NormalizeWord(keyword, keywordLower);
+    return MarkovChain_FindWord(chain, keywordLower);
+}
+
+/* Check that the dictionary has room for count more words of chars characters in all */
+static Boolean HasWordRoom(const MarkovDictionary *dict, short count, unsigned short chars)
+{
+    short available = dict->maxWords - dict->wordCount;
+    WordID id;
+
+    for (id = dict->freeWords; id != kNoWord && available < count; id = dict->wordNorm[id]) {
+        available++;
+    }
+    return available >= count && dict->wordTextUsed + chars <= dict->maxWordChars;
+}
+
+/* Delete a word from the lookup table, shifting later entries of its probe run back */
+static void RemoveWordFromHash(MarkovDictionary *dict, WordID id)
+{
+    short hole = FindWordSlot(dict, WordText(dict, id));
+    short slot = hole;
+    short home;
+    WordID entry;
+
+    for (;;) {
+        slot  = (slot + 1) & dict->wordHashMask;
+        entry = dict->wordHash[slot];
+        if (entry == kNoWord)
+            break;
+
+        /* An entry can fill the hole unless its home slot lies between the hole and itself */
+        home = HashString(WordText(dict, entry)) & dict->wordHashMask;
+        if (((slot - home) & dict->wordHashMask) >= ((slot - hole) & dict->wordHashMask)) {
+            dict->wordHash[hole] = entry;
+            hole                 = slot;
+        }
+    }
+    dict->wordHash[hole] = kNoWord;
+}
+
+/* Return a word's ID to the free list; its text is reclaimed by the next compaction */
+static void FreeWord(MarkovDictionary *dict, WordID id)
+{
+    WordID norm = dict->wordNorm[id];
+
+    RemoveWordFromHash(dict, id);
+    dict->wordOffset[id] = kFreeWordOffset;
+    dict->wordNorm[id]   = dict->freeWords;
+    dict->freeWords      = id;
+
+    /* The normalized form may only have been kept for this word */
+    if (norm != id && --dict->wordRefs[norm] == 0)
+        FreeWord(dict, norm);
+}
+
+/* Slide the text of live words down over that of freed ones */
+static void CompactWordText(MarkovDictionary *dict)
+{
+    unsigned short from = 0;
+    unsigned short to   = 0;
+    unsigned short len;
+    WordID id;
+
+    while (from < dict->wordTextUsed) {
+        len = strlen(&dict->wordText[from]) + 1;
+
+        /* Freed words are out of the lookup table, so only live text finds its own offset */
+        id = FindWord(dict, &dict->wordText[from]);
+        if (id != kNoWord && dict->wordOffset[id] == from) {
+            memmove(&dict->wordText[to], &dict->wordText[from], len);
+            dict->wordOffset[id] = to;
+            to += len;
+        }
+        from += len;
+    }
+
+    dict->wordTextUsed = to;
+}
+
+/* Drop a reference to a word, noting when that may have left it unused */
+static void DropWordRef(MarkovDictionary *dict, WordID id)
+{
+    if (--dict->wordRefs[id] == 0)
+        dict->unusedWords = TRUE;
+}
+
+/* Free every word no node, follower or other word refers to any more */
+static void ReleaseUnusedWords(MarkovDictionary *dict)
+{
+    WordID id;
+
+    /* A full dictionary asks for room on every new word; only scan when it can find some */
+    if (!dict->unusedWords)
+        return;
+    dict->unusedWords = FALSE;
+
+    for (id = 0; id < dict->wordCount; id++) {
+        if (dict->wordOffset[id] != kFreeWordOffset && dict->wordRefs[id] == 0)
+            FreeWord(dict, id);
+    }
+    CompactWordText(dict);
+}
+
+/* Release unused words to make room for count more words of chars characters. When learning,
+ * forget unused contexts until the words only they referred to are released too */
+static void MakeWordRoom(MarkovChain *chain, short count, unsigned short chars)
+{
+    MarkovDictionary *dict = chain->dictionary;
+    short evicted          = 0;
+    short victim;
+    short keep = -1;
+
+    ReleaseUnusedWords(dict);
+    while (chain->evictWhenFull && !HasWordRoom(dict, count, chars) &&
+           evicted < kMaxWordEvictions && chain->nodeCount > kMinLearningNodes(chain)) {
+        victim = FindEvictionVictim(chain, keep);
+        if (victim < 0)
+            break;
+        EvictState(chain, victim, &keep);
+        chain->evictions++;
+
+        /* Releasing scans the whole dictionary, so only do it every few evictions */
+        if (++evicted % kWordEvictionBatch == 0)
+            ReleaseUnusedWords(dict);
+    }
+}
+
+/* Add a word to the dictionary if needed, without making room, returns its ID or kNoWord if
+ * full */
+static WordID AddWord(MarkovDictionary *dict, const char *word)
+{
+    char normalized[MAX_WORD_LENGTH];
+    WordID normId = kNoWord;
+    WordID id;
+    short slot;
+    size_t len;
+
+    slot = FindWordSlot(dict, word);
+    if (dict->wordHash[slot] != kNoWord)
+        return dict->wordHash[slot];
+
+    /* Intern the normalized form first so keyword searches can compare IDs */
+    len = strlen(word) + 1;
+    NormalizeWord(word, normalized);
+    if (strcmp(normalized, word) != 0)
+        normId = AddWord(dict, normalized);
+    slot = FindWordSlot(dict, word); /* Table may have changed */
+
+    if (!HasWordRoom(dict, 1, len)) {
+        if (normId != kNoWord && dict->wordRefs[normId] == 0)
+            dict->unusedWords = TRUE; /* The normalized form was added for nothing */
+        return kNoWord;               /* Dictionary is full */
+    }
+
+    if (dict->freeWords != kNoWord) {
+        id              = dict->freeWords;
+        dict->freeWords = dict->wordNorm[id];
+    }
+    else {
+        id = dict->wordCount++;
+    }
+
+    memcpy(&dict->wordText[dict->wordTextUsed], word, len);
+    dict->wordOffset[id] = dict->wordTextUsed;
+    dict->wordNorm[id]   = (normId != kNoWord) ? normId : id;
+    dict->wordRefs[id]   = 0;
+    dict->wordTextUsed += len;
+    dict->wordHash[slot] = id;
+
+    if (normId != kNoWord)
+        dict->wordRefs[normId]++;
+    return id;
+}
+
+/* Add a word to the chain's dictionary if needed, returns its ID or kNoWord if full */
+static WordID InternWord(MarkovChain *chain, const char *word)
+{
+    MarkovDictionary *dict = chain->dictionary;
+    WordID id              = FindWord(dict, word);
+    size_t len;
+
+    if (id != kNoWord)
+        return id;
+
+    /* Make room for the word and its normalized form from words nothing uses any more */
+    len = strlen(word) + 1;
+    if (!HasWordRoom(dict, 2, 2 * len))
+        MakeWordRoom(chain, 2, 2 * len);
+    return AddWord(dict, word);
+}
+
+/* Hash a (parent context, word) pair into the state index */
+static short HashState(const MarkovChain *chain, WordID parent, WordID word)
+{
+    /* Multiplicative hashing with 16-bit multiplies; the top bits are the best mixed */
+    unsigned short hash = (unsigned short)(parent * 40503u + word) * 40503u;
+    return hash >> (16 - chain->stateHashBits);
+}
+
+/* Find the index slot holding a context, or the empty slot where it belongs */
+static short FindStateSlot(MarkovChain *chain, short parent, WordID word)
+{
+    short mask            = (1 << chain->stateHashBits) - 1;
+    short slot            = HashState(chain, parent, word);
+    unsigned short probes = 1;
+    short node;
+
+    while ((node = chain->stateHash[slot]) >= 0 &&
+           (chain->nodes[node].word != word || chain->nodes[node].parent != parent)) {
+        slot = (slot + 1) & mask;
+        probes++;
+    }
+
+    /* Keep track of probe lengths so the table can be sized from real data */
+    chain->lookupStats.lookups++;
+    chain->lookupStats.probes += probes;
+    if (probes > chain->lookupStats.maxProbes) {
+        chain->lookupStats.maxProbes = probes;
+    }
+
+    return slot;
+}
+
+/* Find the context extending parent (-1 for none) with an older word, returns index or -1 */
+short MarkovChain_FindState(MarkovChain *chain, short parent, WordID word)
+{
+    return chain->stateHash[FindStateSlot(chain, parent, word)];
+}
+
+/* Delete a context from the state index, shifting later entries of its probe run back */
+static void RemoveStateFromHash(MarkovChain *chain, short stateIndex)
+{
+    MarkovNode *node = &chain->nodes[stateIndex];
+    short mask       = (1 << chain->stateHashBits) - 1;
+    short hole       = FindStateSlot(chain, node->parent, node->word);
+    short slot       = hole;
+    short home, entry;
+
+    for (;;) {
+        slot  = (slot + 1) & mask;
+        entry = chain->stateHash[slot];
+        if (entry < 0)
+            break;
+
+        /* An entry can fill the hole unless its home slot lies between the hole and itself */
+        home = HashState(chain, chain->nodes[entry].parent, chain->nodes[entry].word);
+        if (((slot - home) & mask) >= ((slot - hole) & mask)) {
+            chain->stateHash[hole] = entry;
+            hole                   = slot;
+        }
+    }
+    chain->stateHash[hole] = -1;
+}
+
+/* Find the distinct normalized words of a context and the depth each one is posted at */
+static short ContextKeywords(const MarkovChain *chain, short stateIndex, WordID *norms,
+                             short *depths)
+{
+    short node  = stateIndex;
+    short count = 0;
+    short depth, i;
+    WordID norm;
+
+    for (depth = 0; node >= 0 && depth < MARKOV_ORDER; depth++, node = chain->nodes[node].parent) {
+        norm = chain->dictionary->wordNorm[chain->nodes[node].word];
+        if (norm == kSentenceStart)
+            continue; /* Found by MarkovChain_StartsSentence instead, never as a keyword */
+
+        /* A word repeated within one context is only posted once */
+        for (i = 0; i < count && norms[i] != norm; i++)
+            ;
+        if (i < count)
+            continue;
+
+        norms[count]    = norm;
+        depths[count++] = depth;
+    }
+    return count;
+}
+
+/* Post a new context under every distinct normalized word it contains */
+static void AddKeywordPostings(MarkovChain *chain, short stateIndex)
+{
+    WordID norms[MARKOV_ORDER];
+    short depths[MARKOV_ORDER];
+    short count = ContextKeywords(chain, stateIndex, norms, depths);
+    short i, posting;
+
+    for (i = 0; i < count; i++) {
+        posting                      = stateIndex * MARKOV_ORDER + depths[i];
+        chain->keywordNext[posting]  = chain->keywordHead[norms[i]];
+        chain->keywordHead[norms[i]] = posting;
+    }
+}
+
+/* Point a context's postings at a new index, or drop them if newIndex is -1 */
+static void MoveKeywordPostings(MarkovChain *chain, short stateIndex, short newIndex)
+{
+    WordID norms[MARKOV_ORDER];
+    short depths[MARKOV_ORDER];
+    short count = ContextKeywords(chain, stateIndex, norms, depths);
+    short i, posting, moved;
+    short *link;
+
+    for (i = 0; i < count; i++) {
+        posting = stateIndex * MARKOV_ORDER + depths[i];
+
+        /* Lists are singly linked, so find the link that refers to this posting */
+        link = &chain->keywordHead[norms[i]];
+        while (*link != posting) {
+            link = &chain->keywordNext[*link];
+        }
+
+        if (newIndex < 0) {
+            *link = chain->keywordNext[posting];
+        }
+        else {
+            moved                     = newIndex * MARKOV_ORDER + depths[i];
+            chain->keywordNext[moved] = chain->keywordNext[posting];
+            *link                     = moved;
+        }
+    }
+}
+
+/* First posting of a context containing a normalized word, -1 if there are none */
+short MarkovChain_FirstPosting(const MarkovChain *chain, WordID keyword)
+{
+    return chain->keywordHead[keyword];
+}
+
+/* Next posting for the same normalized word, -1 at the end of the list */
+short MarkovChain_NextPosting(const MarkovChain *chain, short posting)
+{
+    return chain->keywordNext[posting];
+}
+
+/* Move a node to a free index, updating everything that refers to it by index */
+static void MoveState(MarkovChain *chain, short from, short to)
+{
+    MarkovNode *node = &chain->nodes[to];
+    short i, moved, slot;
+
+    *node = chain->nodes[from];
+    chain->stateHash[FindStateSlot(chain, node->parent, node->word)] = to;
+    MoveKeywordPostings(chain, from, to);
+    if (node->followerCapacity > 0)
+        chain->followerPool[node->followerStart - 1].word = to;
+
+    /* Children are indexed by their parent, so they have to be rehashed as well */
+    for (i = 0, moved = 0; moved < node->childCount && i < chain->nodeCount; i++) {
+        if (chain->nodes[i].parent != from)
+            continue;
+
+        RemoveStateFromHash(chain, i);
+        chain->nodes[i].parent = to;
+        slot                   = FindStateSlot(chain, to, chain->nodes[i].word);
+        chain->stateHash[slot] = i;
+        moved++;
+    }
+}
+
+/* Pick a leaf context the clock hand finds unused since its last pass, never keep.
+ * Returns -1 if there is none */
+static short FindEvictionVictim(MarkovChain *chain, short keep)
+{
+    MarkovNode *node;
+    short scanned;
+
+    /* Two laps are always enough, as the first clears every recently used flag */
+    for (scanned = 0; scanned < 2 * chain->nodeCount; scanned++) {
+        chain->evictionHand = (chain->evictionHand + 1) % chain->nodeCount;
+        node                = &chain->nodes[chain->evictionHand];
+
+        if (chain->evictionHand == keep || node->childCount > 0 || IsSentenceRoot(node))
+            continue;
+        if (node->recentlyUsed) {
+            node->recentlyUsed = FALSE; /* Second chance */
+            continue;
+        }
+        return chain->evictionHand;
+    }
+    return -1;
+}
+
+/* Forget a leaf context and release what it refers to. The last node moves into its place to
+ * keep the nodes dense, so *keep is updated if that was the one moved */
+static void EvictState(MarkovChain *chain, short victim, short *keep)
+{
+    MarkovNode *node                  = &chain->nodes[victim];
+    const WeightedFollower *followers = MarkovChain_Followers(chain, victim);
+    short last                        = chain->nodeCount - 1;
+    short i;
+
+    RemoveStateFromHash(chain, victim);
+    MoveKeywordPostings(chain, victim, -1);
+    if (node->followerCapacity > 0)
+        chain->followerPool[node->followerStart - 1].word = kFreeFollowerSpan;
+
+    /* Words only this context used become free for the dictionary to reclaim */
+    for (i = 0; i < node->followerCount; i++) {
+        DropWordRef(chain->dictionary, followers[i].word);
+    }
+    DropWordRef(chain->dictionary, node->word);
+    if (node->parent >= 0)
+        chain->nodes[node->parent].childCount--;
+
+    if (victim != last) {
+        MoveState(chain, last, victim);
+        if (*keep == last)
+            *keep = victim;
+    }
+
+    chain->nodeCount--;
+}
+
+/* Find or add the context extending parent with an older word, returns index or -1 if full */
+static short FindOrAddState(MarkovChain *chain, short parent, WordID word)
+{
+    short slot = FindStateSlot(chain, parent, word);
+    MarkovNode *node;
+    short victim;
+
+    if (chain->stateHash[slot] >= 0) {
+        chain->nodes[chain->stateHash[slot]].recentlyUsed = TRUE;
+        return chain->stateHash[slot];
+    }
+
+    if (chain->nodeCount >= chain->maxNodes) {
+        /* Chain is full: forget an unused context if allowed, but never the one we extend */
+        if (!chain->evictWhenFull || (victim = FindEvictionVictim(chain, parent)) < 0) {
+            chain->droppedContexts++;
+            return -1;
+        }
+
+        EvictState(chain, victim, &parent);
+        chain->evictions++;
+        slot = FindStateSlot(chain, parent, word); /* Index has changed */
+    }
+
+    node                   = &chain->nodes[chain->nodeCount];
+    node->parent           = parent;
+    node->word             = word;
+    node->followerStart    = 0;
+    node->followerCount    = 0;
+    node->followerCapacity = 0;
+    node->childCount       = 0;
+    node->order            = (parent >= 0) ? chain->nodes[parent].order + 1 : 1;
+    node->sampleTableValid = FALSE;
+    node->recentlyUsed     = TRUE;
+
+    if (parent >= 0)
+        chain->nodes[parent].childCount++;
+    chain->dictionary->wordRefs[word]++;
+
+    chain->stateHash[slot] = chain->nodeCount;
+    AddKeywordPostings(chain, chain->nodeCount);
+    return chain->nodeCount++;
+}
+
+/* Let training forget least recently used contexts when the chain is full */
+void MarkovChain_SetEviction(MarkovChain *chain, Boolean evictWhenFull)
+{
+    chain->evictWhenFull = evictWhenFull;
+}
+
+/* Find the longest context of recent words (newest first) that has followers, backing off to
+ * shorter contexts as needed, returns index or -1 if even the last word has no followers */
+short MarkovChain_FindContext(MarkovChain *chain, const WordID *recentWords, short count)
+{
+    short best = -1;
+    short node = -1;
+    short i;
+
+    if (count > chain->order)
+        count = chain->order;
+
+    /* Walk down the trie one older word at a time, remembering the deepest useful context */
+    for (i = 0; i < count; i++) {
+        node = MarkovChain_FindState(chain, node, recentWords[i]);
+        if (node < 0)
+            break;
+        if (chain->nodes[node].followerCount > 0)
+            best = node;
+    }
+
+    return best;
+}
+
+/* Get the words of a context, oldest first, returns the number of words */
+short MarkovChain_GetContextWords(const MarkovChain *chain, short stateIndex, WordID *words)
+{
+    short count = 0;
+
+    /* Each node holds the oldest word of its context, so walking up yields them in order */
+    while (stateIndex >= 0) {
+        words[count++] = chain->nodes[stateIndex].word;
+        stateIndex     = chain->nodes[stateIndex].parent;
+    }
+    return count;
+}
+
+/* Get the followers of a state; there are nodes[stateIndex].followerCount of them */
+const WeightedFollower *MarkovChain_Followers(const MarkovChain *chain, short stateIndex)
+{
+    return &chain->followerPool[chain->nodes[stateIndex].followerStart];
+}
+
+/* Slide every live span down over abandoned ones, trimming each to the followers it holds */
+static void CompactFollowerPool(MarkovChain *chain)
+{
+    WeightedFollower *pool = chain->followerPool;
+    unsigned short from    = 0;
+    unsigned short to      = 0;
+    WeightedFollower header;
+    MarkovNode *node;
+
+    while (from < chain->followerPoolUsed) {
+        header = pool[from];
+
+        node   = (header.word != kFreeFollowerSpan) ? &chain->nodes[header.word] : NULL;
+
+        if (node != NULL && node->followerCount == 0) {
+            node->followerCapacity = 0; /* Pruned empty, and a node without capacity has no span */
+        }
+        else if (node != NULL) {
+            /* Spans only ever move down, so a forward walk never overwrites unread entries */
+            memmove(&pool[to + 1], &pool[from + 1], node->followerCount * sizeof(WeightedFollower));
+            pool[to].word          = header.word;
+            pool[to].frequency     = node->followerCount;
+            node->followerStart    = to + 1;
+            node->followerCapacity = node->followerCount;
+            node->sampleTableValid = FALSE;
+            to += 1 + node->followerCount;
+        }
+
+        from += 1 + header.frequency;
+    }
+
+    chain->followerPoolUsed = to;
+}
+
+/* Drop followers seen fewer than minCount times from contexts of minOrder words or more,
+ * keeping each context's most frequent follower if keepBest is set. The sentence root always
+ * keeps its own, or no sentence could start */
+static void PruneFollowerPool(MarkovChain *chain, unsigned short minCount, short minOrder,
+                              Boolean keepBest)
+{
+    WeightedFollower *followers;
+    MarkovNode *node;
+    short i, j, kept, best;
+
+    for (i = 0; i < chain->nodeCount; i++) {
+        node      = &chain->nodes[i];
+        followers = &chain->followerPool[node->followerStart];
+        if (node->followerCount == 0 || node->order < minOrder)
+            continue;
+
+        best = -1;
+        if (keepBest || IsSentenceRoot(node)) {
+            best = 0;
+            for (j = 1; j < node->followerCount; j++) {
+                if (followers[j].frequency > followers[best].frequency)
+                    best = j;
+            }
+        }
+
+        kept = 0;
+        for (j = 0; j < node->followerCount; j++) {
+            if (followers[j].frequency >= minCount || j == best)
+                followers[kept++] = followers[j];
+            else
+                DropWordRef(chain->dictionary, followers[j].word);
+        }
+        node->followerCount    = kept;
+        node->sampleTableValid = FALSE;
+    }
+}
+
+/* Make sure there are count free pool entries, compacting and then pruning if needed */
+static Boolean ReservePoolEntries(MarkovChain *chain, unsigned short count)
+{
+    if (chain->followerPoolUsed + count <= chain->followerPoolSize)
+        return TRUE;
+
+    CompactFollowerPool(chain);
+    if (chain->followerPoolUsed + count <= chain->followerPoolSize)
+        return TRUE;
+
+    /* Over budget: trade the rarest transitions for room to keep learning */
+    if (chain->followerPoolSaturated)
+        return FALSE;
+
+    PruneFollowerPool(chain, 2, 1, TRUE); /* Followers seen only once */
+    CompactFollowerPool(chain);
+    chain->followerPoolPrunes++;
+
+    /* A prune that frees little would just repeat on every new follower, so stop pruning */
+    if (chain->followerPoolSize - chain->followerPoolUsed < kMinPruneGain(chain))
+        chain->followerPoolSaturated = TRUE;
+
+    return chain->followerPoolUsed + count <= chain->followerPoolSize;
+}
+
+/* Drop rare followers, then the contexts and words left unused */
+short MarkovChain_Prune(MarkovChain *chain, unsigned short minCount, short minOrder)
+{
+    short removed = 0;
+    short keep    = -1;
+    short before, i;
+
+    PruneFollowerPool(chain, minCount, minOrder, FALSE);
+
+    /* A context with no followers and no longer contexts adds nothing. Removing one can leave
+     * its parent the same way, so repeat until nothing changes */
+    do {
+        before = removed;
+        for (i = chain->nodeCount - 1; i >= 0; i--) {
+            if (chain->nodes[i].followerCount == 0 && chain->nodes[i].childCount == 0) {
+                EvictState(chain, i, &keep);
+                removed++;
+            }
+        }
+    } while (removed != before);
+
+    CompactFollowerPool(chain);
+    chain->followerPoolSaturated = FALSE; /* There is room to prune again */
+    ReleaseUnusedWords(chain->dictionary);
+    return removed;
+}
+
+/* Prune ever more until the saved chain fits, longest contexts first */
+long MarkovChain_PruneToSize(MarkovChain *chain, long maxSavedSize)
+{
+    unsigned long minCount = 2;
+    long size              = MarkovChain_SavedSize(chain);
+    short minOrder         = chain->order;
+
+    /* Longer contexts back off to shorter ones, so they lose their rare followers first. The
+     * threshold then rises by half each time, so 16-bit counts don't take thousands of steps */
+    while (size > maxSavedSize && chain->nodeCount > 0 && minCount <= kMaxFollowerCount) {
+        MarkovChain_Prune(chain, minCount, minOrder);
+        size = MarkovChain_SavedSize(chain);
+
+        if (--minOrder < 1) {
+            minOrder = chain->order;
+            minCount += (minCount + 1) / 2;
+        }
+    }
+    return size;
+}
+
+/* Pick the leaf context trained least, the longest of those, never a sentence root. Returns -1
+ * if there is none */
+static short FindLeastTrainedLeaf(const MarkovChain *chain)
+{
+    const WeightedFollower *followers;
+    const MarkovNode *node;
+    unsigned long total, leastTotal = 0;
+    short least = -1;
+    short i, j;
+
+    for (i = 0; i < chain->nodeCount; i++) {
+        node = &chain->nodes[i];
+        if (node->childCount > 0 || IsSentenceRoot(node))
+            continue;
+
+        followers = &chain->followerPool[node->followerStart];
+        total     = 0;
+        for (j = 0; j < node->followerCount; j++) {
+            total += followers[j].frequency;
+        }
+        if (least < 0 || total < leastTotal ||
+            (total == leastTotal && node->order > chain->nodes[least].order)) {
+            least      = i;
+            leastTotal = total;
+        }
+    }
+    return least;
+}
+
+/* Drop the least frequent follower of any context that has others, the longest context's first.
+ * Returns FALSE if every context is down to one */
+static Boolean DropRarestFollower(MarkovChain *chain)
+{
+    WeightedFollower *followers;
+    MarkovNode *node;
+    unsigned long rarestCount = 0;
+    short rarestNode          = -1;
+    short rarest              = 0;
+    short i, j;
+
+    for (i = 0; i < chain->nodeCount; i++) {
+        node = &chain->nodes[i];
+        if (node->followerCount < 2)
+            continue;
+
+        followers = &chain->followerPool[node->followerStart];
+        for (j = 0; j < node->followerCount; j++) {
+            if (rarestNode < 0 || followers[j].frequency < rarestCount ||
+                (followers[j].frequency == rarestCount &&
+                 node->order > chain->nodes[rarestNode].order)) {
+                rarestNode  = i;
+                rarest      = j;
+                rarestCount = followers[j].frequency;
+            }
+        }
+    }
+    if (rarestNode < 0)
+        return FALSE;
+
+    node      = &chain->nodes[rarestNode];
+    followers = &chain->followerPool[node->followerStart];
+    DropWordRef(chain->dictionary, followers[rarest].word);
+    for (j = rarest + 1; j < node->followerCount; j++) {
+        followers[j - 1] = followers[j];
+    }
+    node->followerCount--;
+    node->sampleTableValid = FALSE;
+    return TRUE;
+}
+
+/* Forget the least trained contexts until a chain of maxNodes has room for the rest, then the
+ * rarest followers until its follower pool does too */
+short MarkovChain_PruneToCapacity(MarkovChain *chain, short maxNodes)
+{
+    short keep = -1;
+    short victim;
+
+    while (chain->nodeCount > maxNodes && (victim = FindLeastTrainedLeaf(chain)) >= 0) {
+        EvictState(chain, victim, &keep);
+    }
+    while (NeededNodes(chain->nodeCount, LoadedPoolEntries(chain), 0, 0) > maxNodes) {
+        if (!DropRarestFollower(chain)) {
+            if ((victim = FindLeastTrainedLeaf(chain)) < 0)
+                break;
+            EvictState(chain, victim, &keep);
+        }
+    }
+
+    CompactFollowerPool(chain);
+    chain->followerPoolSaturated = FALSE; /* There is room to prune again */
+    ReleaseUnusedWords(chain->dictionary);
+    return MarkovChain_Capacity(chain);
+}
+
+/* Give a node room for more followers, returns FALSE if the pool is exhausted */
+static Boolean GrowFollowerSpan(MarkovChain *chain, short stateIndex)
+{
+    MarkovNode *node       = &chain->nodes[stateIndex];
+    WeightedFollower *pool = chain->followerPool;
+    unsigned short capacity;
+    unsigned short start;
+
+    if (node->followerCapacity >= MAX_FOLLOWERS)
+        return FALSE;
+
+    capacity = (node->followerCapacity < kMinFollowerCapacity) ? kMinFollowerCapacity
+                                                               : node->followerCapacity * 2;
+    if (capacity > MAX_FOLLOWERS)
+        capacity = MAX_FOLLOWERS;
+
+    /* The newest span can simply be extended */
+    if (node->followerCapacity > 0 &&
+        node->followerStart + node->followerCapacity == chain->followerPoolUsed &&
+        chain->followerPoolUsed + capacity - node->followerCapacity <= chain->followerPoolSize) {
+        chain->followerPoolUsed += capacity - node->followerCapacity;
+        pool[node->followerStart - 1].frequency = capacity;
+        node->followerCapacity                  = capacity;
+        return TRUE;
+    }
+
+    /* Otherwise move to a new span at the end; compaction may move our old one first */
+    if (!ReservePoolEntries(chain, capacity + 1))
+        return FALSE;
+
+    start = chain->followerPoolUsed + 1;
+    memcpy(&pool[start], &pool[node->followerStart],
+           node->followerCount * sizeof(WeightedFollower));
+    if (node->followerCapacity > 0)
+        pool[node->followerStart - 1].word = kFreeFollowerSpan;
+
+    pool[start - 1].word      = stateIndex;
+    pool[start - 1].frequency = capacity;
+    node->followerStart       = start;
+    node->followerCapacity    = capacity;
+    chain->followerPoolUsed   = start + capacity;
+    return TRUE;
+}
+
+/* Halve the counts of a context's followers, keeping their proportions. Counts round up, so
+ * no follower drops out; pruning is what removes rare ones */
+static void HalveFollowerCounts(MarkovChain *chain, MarkovNode *node)
+{
+    WeightedFollower *followers = &chain->followerPool[node->followerStart];
+    short i;
+
+    for (i = 0; i < node->followerCount; i++) {
+        followers[i].frequency = (followers[i].frequency >> 1) + (followers[i].frequency & 1);
+    }
+    chain->countHalvings++;
+}
+
+/* Add count to a follower of a state in the chain, adding the follower if it is new */
+static void AddFollower(MarkovChain *chain, short stateIndex, WordID follower,
+                        unsigned short count)
+{
+    MarkovNode *node            = &chain->nodes[stateIndex];
+    WeightedFollower *followers = &chain->followerPool[node->followerStart];
+    unsigned long total         = 0;
+    Boolean hasRoom;
+    short i, found = -1;
+
+    /* Counts are about to change, rebuild the sampling table on next use */
+    node->sampleTableValid = FALSE;
+
+    /* Check if we already have this follower, totalling the counts on the way */
+    for (i = 0; i < node->followerCount; i++) {
+        total += followers[i].frequency;
+        if (followers[i].word == follower)
+            found = i;
+    }
+
+    /* Normalize before a count saturates or the sampling weights overflow, rather than letting
+     * the most common transitions flatten out at the limit */
+    if (total + count > kMaxFollowerTotal ||
+        (found >= 0 && followers[found].frequency + count > kMaxFollowerCount))
+        HalveFollowerCounts(chain, node);
+
+    if (found >= 0) {
+        followers[found].frequency += count;
+        return;
+    }
+
+    /* Add new follower, growing the node's span in the pool if there's space. Growing can
+     * compact or prune the pool, which moves the span, so look it up again afterwards */
+    hasRoom   = node->followerCount < node->followerCapacity || GrowFollowerSpan(chain, stateIndex);
+    followers = &chain->followerPool[node->followerStart];
+
+    if (hasRoom) {
+        followers[node->followerCount].word      = follower;
+        followers[node->followerCount].frequency = count;
+        node->followerCount++;
+        chain->dictionary->wordRefs[follower]++;
+    }
+    else if (node->followerCount > 0) {
+        /* No room anywhere, potentially replace a random low-frequency follower */
+        short replace_idx = Random_Below(&chain->random, node->followerCount);
+        if (followers[replace_idx].frequency == 1) {
+            DropWordRef(chain->dictionary, followers[replace_idx].word);
+            chain->dictionary->wordRefs[follower]++;
+            followers[replace_idx].word      = follower;
+            followers[replace_idx].frequency = count;
+        }
+    }
+}
+
+/* Change the sampling temperature (percent) and top-k, invalidating the sampling tables */
+void MarkovChain_SetSampling(MarkovChain *chain, short temperature, short topK)
+{
+    short i;
+
+    chain->temperature = (temperature > 0) ? temperature : 1;
+    chain->topK        = (topK > 0) ? topK : 0;
+
+    for (i = 0; i < chain->nodeCount; i++) {
+        chain->nodes[i].sampleTableValid = FALSE;
+    }
+}
+
+/* Number of followers a node samples from under the current top-k */
+static short SampleCount(const MarkovChain *chain, const MarkovNode *node)
+{
+    return (chain->topK > 0 && chain->topK < node->followerCount) ? chain->topK
+                                                                  : node->followerCount;
+}
+
+/* Sort a node's followers most frequent first and build its cumulative weight table */
+static void BuildSampleTable(MarkovChain *chain, short stateIndex)
+{
+    MarkovNode *node            = &chain->nodes[stateIndex];
+    WeightedFollower *followers = &chain->followerPool[node->followerStart];
+    unsigned short *table       = &chain->sampleTable[node->followerStart];
+    unsigned short total        = 0;
+    short count                 = SampleCount(chain, node);
+    WeightedFollower entry;
+    short i, j;
+
+    /* Insertion sort: lists are short and usually nearly sorted already */
+    for (i = 1; i < node->followerCount; i++) {
+        entry = followers[i];
+        for (j = i; j > 0 && followers[j - 1].frequency < entry.frequency; j--) {
+            followers[j] = followers[j - 1];
+        }
+        followers[j] = entry;
+    }
+
+    for (i = 0; i < count; i++) {
+        unsigned short weight = followers[i].frequency;
+
+        /* Reshape the weights only when asked; floating point is slow without an FPU */
+        if (chain->temperature != 100) {
+            double ratio = (double)weight / followers[0].frequency;
+            double power = 100.0 / chain->temperature;
+
+            weight = (unsigned short)(kSampleWeightScale * pow(ratio, power) + 0.5);
+            if (weight == 0)
+                weight = 1; /* Cooling never removes a follower outright */
+        }
+
+        total += weight;
+        table[i] = total;
+    }
+
+    node->sampleTableValid = TRUE;
+}
+
+/* log2 of 1 to 31 in kLogProbScale units, rounded (0 is never looked up) */
+static const unsigned char kLog2Table[32] = {0,  0,  16, 25, 32, 37, 41, 45, 48, 51, 53,
+                                             55, 57, 59, 61, 63, 64, 65, 67, 68, 69, 70,
+                                             71, 72, 73, 74, 75, 76, 77, 78, 79, 79};
+
+/* log2 of a positive value in kLogProbScale units, to within a unit */
+short MarkovChain_Log2(unsigned long value)
+{
+    short shift = 0;
+
+    while (value >= 32) {
+        value >>= 1;
+        shift++;
+    }
+    return shift * kLogProbScale + kLog2Table[value];
+}
+
+/* Pick a follower of a state by weight, and the log probability of picking it */
+WordID MarkovChain_SampleFollowerScored(MarkovChain *chain, short stateIndex,
+                                        RandomStream *random, short *logProb)
+{
+    MarkovNode *node = &chain->nodes[stateIndex];
+    unsigned short *table;
+    unsigned short target;
+    short low, high, mid;
+
+    if (node->followerCount == 0)
+        return kNoWord;
+
+    node->recentlyUsed = TRUE;
+    if (!node->sampleTableValid)
+        BuildSampleTable(chain, stateIndex);
+
+    /* Binary search for the first follower whose cumulative weight exceeds the target */
+    table  = &chain->sampleTable[node->followerStart];
+    low    = 0;
+    high   = SampleCount(chain, node) - 1;
+    target = Random_Below(random, table[high]);
+
+    while (low < high) {
+        mid = (low + high) / 2;
+        if (table[mid] > target)
+            high = mid;
+        else
+            low = mid + 1;
+    }
+
+    /* The pick's own weight over the total; high is the last follower again after the search */
+    if (logProb != NULL) {
+        high     = SampleCount(chain, node) - 1;
+        *logProb = MarkovChain_Log2(table[low] - (low > 0 ? table[low - 1] : 0)) -
+                   MarkovChain_Log2(table[high]);
+    }
+
+    return chain->followerPool[node->followerStart + low].word;
+}
+
+/* Pick a follower of a state by weight, returns kNoWord if the state has none */
+WordID MarkovChain_SampleFollower(MarkovChain *chain, short stateIndex, RandomStream *random)
+{
+    return MarkovChain_SampleFollowerScored(chain, stateIndex, random, NULL);
+}
+
+/* Get a state's most likely followers; the sample table already has them in order */
+short MarkovChain_LikelyFollowers(MarkovChain *chain, short stateIndex, short max, WordID *words,
+                                  short *logProbs)
+{
+    MarkovNode *node = &chain->nodes[stateIndex];
+    unsigned short *table;
+    short count, totalLog, i;
+
+    if (node->followerCount == 0)
+        return 0;
+
+    node->recentlyUsed = TRUE;
+    if (!node->sampleTableValid)
+        BuildSampleTable(chain, stateIndex);
+
+    table    = &chain->sampleTable[node->followerStart];
+    count    = SampleCount(chain, node);
+    totalLog = MarkovChain_Log2(table[count - 1]);
+    if (count > max)
+        count = max;
+
+    for (i = 0; i < count; i++) {
+        words[i]    = chain->followerPool[node->followerStart + i].word;
+        logProbs[i] = MarkovChain_Log2(table[i] - (i > 0 ? table[i - 1] : 0)) - totalLog;
+    }
+    return count;
+}
+
+/* Get the sampling weight of one of a state's followers, and the total of all of them */
+unsigned short MarkovChain_FollowerWeight(MarkovChain *chain, short stateIndex, WordID word,
+                                          unsigned short *total)
+{
+    MarkovNode *node = &chain->nodes[stateIndex];
+    const WeightedFollower *followers;
+    unsigned short *table;
+    short count, i;
+
+    *total = 0;
+    if (node->followerCount == 0)
+        return 0;
+    if (!node->sampleTableValid)
+        BuildSampleTable(chain, stateIndex);
+
+    followers = &chain->followerPool[node->followerStart];
+    table     = &chain->sampleTable[node->followerStart];
+    count     = SampleCount(chain, node);
+    *total    = table[count - 1];
+    for (i = 0; i < count; i++) {
+        if (followers[i].word == word)
+            return table[i] - (i > 0 ? table[i - 1] : 0);
+    }
+    return 0; /* Not a follower, or cut off by top-k */
+}
+
+/* Length of a word once punctuation other than sentence enders is cut from its end */
+short MarkovChain_CleanWordLength(const char *word, short length, Boolean *isEndOfSentence)
+{
+    short i;
+
+    /* Control characters are reserved for the sentence markers */
+    if (Tokenizer_Is(word[0], kCharControl))
+        return 0;
+
+    *isEndOfSentence = Tokenizer_Is(word[length - 1], kCharEnder);
+    for (i = length - 1; i > 0 && Tokenizer_Is(word[i], kCharPunct); i--) {
+        if (!Tokenizer_Is(word[i], kCharEnder))
+            length = i;
+    }
+    return length;
+}
+
+/* Count a word as a follower of every context order ending at the newest recent word */
+static void CountFollower(MarkovChain *chain, const WordID *recentWords, short recentCount,
+                          WordID word)
+{
+    short node = -1;
+    short order;
+
+    for (order = 1; order <= recentCount; order++) {
+        node = FindOrAddState(chain, node, recentWords[order - 1]);
+        if (node < 0)
+            break; /* Chain is full, longer contexts can't exist either */
+
+        AddFollower(chain, node, word, 1);
+    }
+}
+
+/* Add count to a follower of one context, given as words newest first */
+Boolean MarkovChain_AddCount(MarkovChain *chain, const char *const *context, short order,
+                             const char *follower, unsigned short count)
+{
+    WordID words[MARKOV_MAX_ORDER + 1];
+    short held, node = -1;
+    short i;
+
+    if (order < 1 || order > chain->order)
+        return FALSE;
+
+    /* Hold each word as it is found, so making room for the next can't reclaim it */
+    for (held = 0; held <= order; held++) {
+        words[held] = InternWord(chain, (held < order) ? context[held] : follower);
+        if (words[held] == kNoWord) {
+            chain->droppedWords++;
+            break;
+        }
+        chain->dictionary->wordRefs[words[held]]++;
+    }
+
+    for (i = 0; held > order && i < order; i++) {
+        node = FindOrAddState(chain, node, words[i]);
+        if (node < 0)
+            break; /* Chain is full */
+    }
+    if (node >= 0)
+        AddFollower(chain, node, words[order], count);
+
+    for (i = 0; i < held; i++) {
+        DropWordRef(chain->dictionary, words[i]);
+    }
+    return node >= 0;
+}
+
+/* Take back one count of a follower from a context, dropping the follower once none are left.
+ * Nothing happens if the context no longer has it, as when it was replaced or pruned since */
+static void RemoveFollower(MarkovChain *chain, short stateIndex, WordID follower)
+{
+    MarkovNode *node            = &chain->nodes[stateIndex];
+    WeightedFollower *followers = &chain->followerPool[node->followerStart];
+    short i;
+
+    for (i = 0; i < node->followerCount && followers[i].word != follower; i++)
+        ;
+    if (i == node->followerCount)
+        return;
+
+    node->sampleTableValid = FALSE;
+    if (--followers[i].frequency > 0)
+        return;
+
+    DropWordRef(chain->dictionary, follower);
+    followers[i] = followers[--node->followerCount];
+}
+
+/* Take back a count of a word from every context order ending at the newest recent word, then
+ * forget the contexts that are left with no followers and no longer contexts */
+static void UncountFollower(MarkovChain *chain, const WordID *recentWords, short recentCount,
+                            WordID word)
+{
+    short path[MARKOV_MAX_ORDER];
+    short node = -1;
+    short order, keep;
+
+    for (order = 0; order < recentCount; order++) {
+        node = chain->stateHash[FindStateSlot(chain, node, recentWords[order])];
+        if (node < 0)
+            break; /* Longer contexts can't exist either */
+
+        path[order] = node;
+        RemoveFollower(chain, node, word);
+    }
+
+    /* Longest first, as forgetting a context can leave its parent empty too. Eviction moves the
+     * last node into the hole, so the parent's index is passed along to be kept up to date */
+    while (--order >= 0) {
+        node = path[order];
+        if (chain->nodes[node].followerCount > 0 || chain->nodes[node].childCount > 0 ||
+            IsSentenceRoot(&chain->nodes[node]))
+            break;
+
+        keep = (order > 0) ? path[order - 1] : -1;
+        EvictState(chain, node, &keep);
+        if (order > 0)
+            path[order - 1] = keep;
+    }
+}
+
+/* Count a word as a follower of its contexts when training, or take the count back */
+static void ChangeFollower(MarkovChain *chain, const WordID *recentWords, short recentCount,
+                           WordID word, Boolean untrain)
+{
+    if (untrain)
+        UncountFollower(chain, recentWords, recentCount, word);
+    else
+        CountFollower(chain, recentWords, recentCount, word);
+}
+
+/* Make a word the newest of the recent words. The window holds a reference to each word in it,
+ * so they can't be reclaimed while training */
+static void PushTrainingWord(MarkovChain *chain, WordID *recentWords, short *recentCount,
+                             WordID word)
+{
+    short i;
+
+    if (*recentCount == chain->order)
+        DropWordRef(chain->dictionary, recentWords[*recentCount - 1]);
+    for (i = (*recentCount < chain->order) ? *recentCount : chain->order - 1; i > 0; i--) {
+        recentWords[i] = recentWords[i - 1];
+    }
+    recentWords[0] = word;
+    chain->dictionary->wordRefs[word]++;
+    if (*recentCount < chain->order)
+        (*recentCount)++;
+}
+
+/* Forget the recent words, so nothing is counted across a gap */
+static void ClearTrainingWords(MarkovChain *chain, WordID *recentWords, short *recentCount)
+{
+    while (*recentCount > 0) {
+        DropWordRef(chain->dictionary, recentWords[--*recentCount]);
+    }
+}
+
+/* Start a sentence from the start marker alone, so contexts never span two sentences */
+static void StartTrainingSentence(MarkovChain *chain, WordID *recentWords, short *recentCount)
+{
+    ClearTrainingWords(chain, recentWords, recentCount);
+    PushTrainingWord(chain, recentWords, recentCount, kSentenceStart);
+}
+
+/* A walk through training text a sentence at a time, counting each word as a follower of every
+ * context order, or taking those counts back. The text may come a token list at a time */
+typedef struct {
+    WordID recentWords[MARKOV_MAX_ORDER]; /* Newest first */
+    short recentCount;
+    short sentenceWords; /* Words seen so far in the current sentence */
+    Boolean untrain;
+} TrainingWalk;
+
+/* Start a walk at the start of a sentence */
+static void BeginTrainingWalk(MarkovChain *chain, TrainingWalk *walk, Boolean untrain)
+{
+    walk->recentCount   = 0;
+    walk->sentenceWords = 0;
+    walk->untrain       = untrain;
+    StartTrainingSentence(chain, walk->recentWords, &walk->recentCount);
+}
+
+/* Walk on through a list of tokens */
+static void WalkTrainingTokens(MarkovChain *chain, TrainingWalk *walk, const TokenList *tokens)
+{
+    char text[kMaxTokenLength + 1];
+    const Token *token;
+    short length, i;
+    WordID word;
+    Boolean endsSentence;
+
+    for (i = 0; i < tokens->count; i++) {
+        token  = &tokens->tokens[i];
+        length = MarkovChain_CleanWordLength(Tokenizer_Word(tokens, token), token->length,
+                                             &endsSentence);
+        if (length == 0)
+            continue;
+        Tokenizer_CopyWord(tokens, token, length, text, sizeof(text));
+
+        /* A word the full dictionary can't take leaves a gap; counting across it would join
+         * words that never met, and could end the sentence early. Untraining only looks words
+         * up, so gaps fall in the same places */
+        word = walk->untrain ? MarkovChain_FindWord(chain, text) : InternWord(chain, text);
+        if (word != kNoWord) {
+            ChangeFollower(chain, walk->recentWords, walk->recentCount, word, walk->untrain);
+            PushTrainingWord(chain, walk->recentWords, &walk->recentCount, word);
+            walk->sentenceWords++;
+        }
+        else {
+            ClearTrainingWords(chain, walk->recentWords, &walk->recentCount);
+            if (!walk->untrain)
+                chain->droppedWords++;
+        }
+
+        if (endsSentence) {
+            ChangeFollower(chain, walk->recentWords, walk->recentCount, kSentenceEnd,
+                           walk->untrain);
+            StartTrainingSentence(chain, walk->recentWords, &walk->recentCount);
+            walk->sentenceWords = 0;
+        }
+    }
+}
+
+/* Finish a walk, releasing the recent words */
+static void EndTrainingWalk(MarkovChain *chain, TrainingWalk *walk)
+{
+    short i;
+
+    /* Text that stops without punctuation still ends its sentence */
+    if (walk->sentenceWords > 0)
+        ChangeFollower(chain, walk->recentWords, walk->recentCount, kSentenceEnd, walk->untrain);
+
+    for (i = 0; i < walk->recentCount; i++) {
+        DropWordRef(chain->dictionary, walk->recentWords[i]);
+    }
+}
+
+/* Walk text a token list at a time */
+static void WalkTrainingText(MarkovChain *chain, const char *text, Boolean untrain)
+{
+    TokenList tokens;
+    TrainingWalk walk;
+
+    if (!text || !*text)
+        return;
+
+    BeginTrainingWalk(chain, &walk, untrain);
+    while (*text) {
+        text += Tokenizer_Split(&tokens, text);
+        WalkTrainingTokens(chain, &walk, &tokens);
+    }
+    EndTrainingWalk(chain, &walk);
+}
+
+/* Train a chain with new text, counting followers for every context order */
+void MarkovChain_Train(MarkovChain *chain, const char *text)
+{
+    WalkTrainingText(chain, text, FALSE);
+}
+
+/* Train a chain with text that is already split into tokens */
+void MarkovChain_TrainTokens(MarkovChain *chain, const TokenList *tokens)
+{
+    TrainingWalk walk;
+
+    if (tokens->count == 0)
+        return;
+
+    BeginTrainingWalk(chain, &walk, FALSE);
+    WalkTrainingTokens(chain, &walk, tokens);
+    EndTrainingWalk(chain, &walk);
+}
+
+/* Take back what training the same text added */
+void MarkovChain_Untrain(MarkovChain *chain, const char *text)
+{
+    WalkTrainingText(chain, text, TRUE);
+}
+
+/* Hand out the next part of a chain's block, or just count it when there is no block yet */
+static void *CarveStorage(char *base, long *offset, long bytes)
+{
+    void *part = (base != NULL) ? base + *offset : NULL;
+
+    /* Keep every array aligned for a pointer, as the dictionary holds some; a long on the Mac */
+    *offset += (bytes + sizeof(void *) - 1) & ~(long)(sizeof(void *) - 1);
+    return part;
+}
+
+/* Work out a dictionary's capacities and where its arrays go in a block at base (NULL to only
+ * measure), from offset on */
+static void LayoutDictionary(MarkovDictionary *dict, char *base, long *offset, short maxWords)
+{
+    long wordHashSize, maxWordChars;
+
+    maxWordChars = (long)maxWords * MAX_DICT_CHARS / MAX_DICT_WORDS;
+    if (maxWordChars > kMarkovMaxWordText - maxWords)
+        maxWordChars = kMarkovMaxWordText - maxWords;
+    dict->maxWords     = maxWords;
+    dict->maxWordChars = maxWordChars;
+
+    /* A third more word slots than words */
+    for (wordHashSize = 1; wordHashSize < maxWords + maxWords / 3; wordHashSize *= 2)
+        ;
+    dict->wordHashMask = wordHashSize - 1;
+
+    dict->wordOffset = CarveStorage(base, offset, maxWords * sizeof(unsigned short));
+    dict->wordNorm   = CarveStorage(base, offset, maxWords * sizeof(WordID));
+    dict->wordRefs   = CarveStorage(base, offset, maxWords * sizeof(unsigned short));
+    dict->wordHash   = CarveStorage(base, offset, wordHashSize * sizeof(WordID));
+    dict->wordText   = CarveStorage(base, offset, dict->maxWordChars);
+}
+
+/* Work out a chain's capacities and where its arrays go in a block at base (NULL to only
+ * measure), returns the size of the block. A chain that owns its dictionary gets one in
+ * proportion to its nodes at the end of the block; maxWords is the size of a shared one */
+static long LayoutChain(MarkovChain *chain, char *base, short maxNodes, short maxWords,
+                        Boolean ownDictionary)
+{
+    MarkovDictionary measured;
+    long offset = 0;
+    long poolSize, nodes, words;
+
+    if (maxNodes < kMarkovMinNodes)
+        maxNodes = kMarkovMinNodes;
+    if (maxNodes > kMarkovMaxNodes)
+        maxNodes = kMarkovMaxNodes;
+
+    /* Everything else grows in proportion to the nodes */
+    poolSize = (long)maxNodes * MAX_FOLLOWER_POOL / MAX_NODES;
+    if (poolSize > 0xFFFE)
+        poolSize = 0xFFFE; /* Pool indices are 16-bit */
+    chain->maxNodes         = maxNodes;
+    chain->followerPoolSize = poolSize;
+    if (ownDictionary) {
+        words    = (long)maxNodes * MAX_DICT_WORDS / MAX_NODES;
+        maxWords = (words < kMarkovMaxWords) ? words : kMarkovMaxWords;
+    }
+
+    /* Twice as many state slots as nodes */
+    for (chain->stateHashBits = 1; (1L << chain->stateHashBits) < 2L * maxNodes;
+         chain->stateHashBits++)
+        ;
+
+    nodes = maxNodes;
+    CarveStorage(base, &offset, sizeof(MarkovChain));
+    chain->nodes        = CarveStorage(base, &offset, nodes * sizeof(MarkovNode));
+    chain->stateHash    = CarveStorage(base, &offset, sizeof(short) << chain->stateHashBits);
+    chain->keywordHead  = CarveStorage(base, &offset, maxWords * sizeof(short));
+    chain->keywordNext  = CarveStorage(base, &offset, nodes * MARKOV_ORDER * sizeof(short));
+    chain->followerPool = CarveStorage(base, &offset, poolSize * sizeof(WeightedFollower));
+    chain->sampleTable  = CarveStorage(base, &offset, poolSize * sizeof(unsigned short));
+
+    if (ownDictionary) {
+        chain->dictionary = CarveStorage(base, &offset, sizeof(MarkovDictionary));
+        LayoutDictionary((base != NULL) ? chain->dictionary : &measured, base, &offset, maxWords);
+    }
+    return offset;
+}
+
+/* Bytes a chain with room for maxNodes contexts needs, everything included */
+long MarkovChain_StorageSize(short maxNodes)
+{
+    MarkovChain layout;
+
+    return LayoutChain(&layout, NULL, maxNodes, 0, TRUE);
+}
+
+/* Bytes a chain sharing a dictionary of maxWords words needs, dictionary not included */
+long MarkovChain_SharedStorageSize(short maxNodes, short maxWords)
+{
+    MarkovChain layout;
+
+    return LayoutChain(&layout, NULL, maxNodes, maxWords, FALSE);
+}
+
+/* Set up an empty chain in a block of MarkovChain_StorageSize(maxNodes) bytes */
+MarkovChain *MarkovChain_Init(void *storage, short maxNodes)
+{
+    MarkovChain *chain = (MarkovChain *)storage;
+
+    LayoutChain(chain, (char *)storage, maxNodes, 0, TRUE);
+    chain->sharedDictionary = FALSE;
+    chain->nodeCount        = 0; /* No words to give back */
+    MarkovChain_Reset(chain);
+    return chain;
+}
+
+/* Set up an empty chain sharing another chain's dictionary */
+MarkovChain *MarkovChain_InitShared(void *storage, short maxNodes, MarkovDictionary *dictionary)
+{
+    MarkovChain *chain = (MarkovChain *)storage;
+
+    LayoutChain(chain, (char *)storage, maxNodes, dictionary->maxWords, FALSE);
+    chain->dictionary       = dictionary;
+    chain->sharedDictionary = TRUE;
+    chain->nodeCount        = 0;
+    MarkovChain_Reset(chain);
+    return chain;
+}
+
+/* Empty a chain, leaving its dictionary alone */
+static void ClearChain(MarkovChain *chain)
+{
+    chain->nodeCount       = 0;
+    chain->order           = MARKOV_ORDER;
+    chain->temperature     = MARKOV_DEFAULT_TEMPERATURE;
+    chain->topK            = MARKOV_DEFAULT_TOP_K;
+    chain->evictWhenFull   = FALSE;
+    chain->evictionHand    = 0;
+    chain->evictions       = 0;
+    chain->droppedWords    = 0;
+    chain->droppedContexts = 0;
+
+    /* Reset the state index and its statistics */
+    memset(chain->stateHash, 0xFF, sizeof(short) << chain->stateHashBits); /* All slots -1 */
+    memset(&chain->lookupStats, 0, sizeof(chain->lookupStats));
+
+    /* Empty the follower pool and the postings */
+    chain->followerPoolUsed      = 0;
+    chain->followerPoolPrunes    = 0;
+    chain->followerPoolSaturated = FALSE;
+    chain->countHalvings         = 0;
+    memset(chain->keywordHead, 0xFF, chain->dictionary->maxWords * sizeof(short)); /* Empty */
+
+    Random_Seed(&chain->random, kRandomFixedSeed, kRandomStreamChain); /* Same model every time */
+}
+
+/* Empty a dictionary, sentence markers and all */
+static void ClearDictionary(MarkovDictionary *dict)
+{
+    dict->wordCount    = 0;
+    dict->wordTextUsed = 0;
+    dict->freeWords    = kNoWord;
+    dict->unusedWords  = FALSE;
+    memset(dict->wordRefs, 0, dict->maxWords * sizeof(unsigned short));
+    memset(dict->wordHash, 0xFF, (dict->wordHashMask + 1L) * sizeof(WordID)); /* kNoWord */
+}
+
+/* Take a reference to every word a chain's contexts and followers use */
+static void TakeChainWordRefs(MarkovChain *chain)
+{
+    const WeightedFollower *followers;
+    short i, j;
+
+    for (i = 0; i < chain->nodeCount; i++) {
+        followers = MarkovChain_Followers(chain, i);
+        for (j = 0; j < chain->nodes[i].followerCount; j++) {
+            chain->dictionary->wordRefs[followers[j].word]++;
+        }
+        chain->dictionary->wordRefs[chain->nodes[i].word]++;
+    }
+}
+
+/* Give back the references TakeChainWordRefs takes */
+static void DropChainWordRefs(MarkovChain *chain)
+{
+    const WeightedFollower *followers;
+    short i, j;
+
+    for (i = 0; i < chain->nodeCount; i++) {
+        followers = MarkovChain_Followers(chain, i);
+        for (j = 0; j < chain->nodes[i].followerCount; j++) {
+            DropWordRef(chain->dictionary, followers[j].word);
+        }
+        DropWordRef(chain->dictionary, chain->nodes[i].word);
+    }
+}
+
+/* Empty a chain, ready for training */
+void MarkovChain_Reset(MarkovChain *chain)
+{
+    MarkovDictionary *dict = chain->dictionary;
+
+    if (chain->sharedDictionary) {
+        DropChainWordRefs(chain);
+        ClearChain(chain);
+        return;
+    }
+
+    ClearChain(chain);
+    ClearDictionary(dict);
+
+    /* The sentence markers take the first IDs. The dictionary holds a reference to each
+     * itself, so they are never reclaimed */
+    AddWord(dict, kSentenceStartText);
+    AddWord(dict, kSentenceEndText);
+    dict->wordRefs[kSentenceStart] = 1;
+    dict->wordRefs[kSentenceEnd]   = 1;
+}
+
+/* Hold a reference to every word with an ID below count, so none of them is reclaimed */
+void MarkovChain_HoldWords(MarkovChain *chain, short count)
+{
+    MarkovDictionary *dict = chain->dictionary;
+    short i;
+
+    for (i = 0; i < count && i < dict->wordCount; i++) {
+        if (dict->wordOffset[i] != kFreeWordOffset)
+            dict->wordRefs[i]++;
+    }
+}
+
+/* Get state lookup statistics for sizing the hash index */
+void MarkovChain_GetLookupStats(const MarkovChain *chain, MarkovLookupStats *stats)
+{
+    *stats            = chain->lookupStats;
+    stats->stateCount = chain->nodeCount;
+    stats->tableSize  = 1 << chain->stateHashBits;
+}
+
+/* Get how full a chain is and the shape of its contents */
+void MarkovChain_GetStats(const MarkovChain *chain, MarkovChainStats *stats)
+{
+    const MarkovDictionary *dict = chain->dictionary;
+    const WeightedFollower *followers;
+    const MarkovNode *node;
+    short bucket, count, i, j;
+
+    memset(stats, 0, sizeof(*stats));
+    stats->nodeCount = chain->nodeCount;
+    stats->maxNodes  = chain->maxNodes;
+
+    for (i = 0; i < chain->nodeCount; i++) {
+        node = &chain->nodes[i];
+        stats->nodesByOrder[node->order - 1]++;
+        if (MarkovChain_StartsSentence(chain, i))
+            stats->startNodes++;
+
+        /* Bucket b holds counts from 2^(b-1) to 2^b - 1 */
+        count = node->followerCount;
+        for (bucket = 0; count > 0; bucket++) {
+            count >>= 1;
+        }
+        stats->followerHistogram[bucket]++;
+        stats->followers += node->followerCount;
+        if (node->followerCount > stats->mostFollowers)
+            stats->mostFollowers = node->followerCount;
+        if (node->followerCount == MAX_FOLLOWERS)
+            stats->saturatedNodes++;
+
+        followers = &chain->followerPool[node->followerStart];
+        for (j = 0; j < node->followerCount; j++) {
+            if (followers[j].frequency == kMaxFollowerCount)
+                stats->saturatedCounts++;
+        }
+    }
+
+    stats->countHalvings   = chain->countHalvings;
+    stats->poolUsed        = chain->followerPoolUsed;
+    stats->poolSize        = chain->followerPoolSize;
+    stats->poolPrunes      = chain->followerPoolPrunes;
+    stats->evictions       = chain->evictions;
+    stats->droppedWords    = chain->droppedWords;
+    stats->droppedContexts = chain->droppedContexts;
+
+    for (i = 0; i < dict->wordCount; i++) {
+        if (dict->wordOffset[i] != kFreeWordOffset)
+            stats->wordCount++;
+    }
+    stats->maxWords     = dict->maxWords;
+    stats->wordChars    = dict->wordTextUsed;
+    stats->maxWordChars = dict->maxWordChars;
+    stats->memoryBytes  = chain->sharedDictionary
+                              ? MarkovChain_SharedStorageSize(chain->maxNodes, dict->maxWords)
+                              : MarkovChain_StorageSize(chain->maxNodes);
+
+    MarkovChain_GetLookupStats(chain, &stats->lookup);
+}
+
+/* Store a 16-bit value big-endian, the native order of the 68000 */
+static unsigned char *PutShort(unsigned char *p, unsigned short value)
+{
+    p[0] = value >> 8;
+    p[1] = value & 0xFF;
+    return p + 2;
+}
+
+/* Read a big-endian 16-bit value */
+static unsigned short GetShort(const unsigned char *p)
+{
+    return (p[0] << 8) | p[1];
+}
+
+/* Bytes of dictionary text in the model format, where free IDs are saved as empty words */
+static unsigned short SavedTextSize(const MarkovDictionary *dict)
+{
+    unsigned short size = 0;
+    short i;
+
+    for (i = 0; i < dict->wordCount; i++) {
+        size += 1;
+        if (dict->wordOffset[i] != kFreeWordOffset)
+            size += strlen(WordText(dict, i));
+    }
+    return size;
+}
+
+/* Number of dictionary words saved with a chain; only the chain that owns it saves it */
+static short SavedWordCount(const MarkovChain *chain)
+{
+    return chain->sharedDictionary ? 0 : chain->dictionary->wordCount;
+}
+
+/* Store a 32-bit value big-endian */
+static unsigned char *PutLong(unsigned char *p, unsigned long value)
+{
+    p = PutShort(p, value >> 16);
+    return PutShort(p, value & 0xFFFF);
+}
+
+/* Read a big-endian 32-bit value */
+static unsigned long GetLong(const unsigned char *p)
+{
+    return ((unsigned long)GetShort(p) << 16) | GetShort(p + 2);
+}
+
+/* Adler-32 of a block, to catch damaged or partly written models */
+static unsigned long Checksum(const unsigned char *data, long size)
+{
+    unsigned long a = 1;
+    unsigned long b = 0;
+    long chunk;
+
+    while (size > 0) {
+        /* The sums can't overflow within this many bytes, so divide once per chunk */
+        chunk = (size < 5552) ? size : 5552;
+        size -= chunk;
+        while (chunk-- > 0) {
+            a += *data++;
+            b += a;
+        }
+        a %= 65521;
+        b %= 65521;
+    }
+    return (b << 16) | a;
+}
+
+/* Get the checksum stored in a model's header without checking the rest, 0 if not a model */
+unsigned long MarkovChain_ModelChecksum(const unsigned char *data, long size)
+{
+    if (size < MODEL_HEADER_SIZE || GetShort(data) != (MODEL_MAGIC >> 16) ||
+        GetShort(data + 2) != (MODEL_MAGIC & 0xFFFF) || GetShort(data + 4) != MODEL_VERSION)
+        return 0;
+    return GetLong(data + 14);
+}
+
+/* Number of dictionary words a model carries, from its header alone, 0 if it isn't a model */
+short MarkovChain_ModelWords(const unsigned char *data, long size)
+{
+    /* Adler-32 starts its low half at 1, so no real model has a checksum of 0 */
+    return (MarkovChain_ModelChecksum(data, size) != 0) ? GetShort(data + 10) : 0;
+}
+
+/* Smallest maxNodes of a chain with room for nodeCount contexts, entries follower pool entries
+ * and a dictionary of wordCount words saved in textSize bytes. Everything comes in proportion
+ * to the nodes, so any of them may be what needs the room */
+static long NeededNodes(long nodeCount, unsigned long entries, long wordCount, long textSize)
+{
+    long needed = nodeCount;
+    long poolNodes, words, wordNodes;
+
+    poolNodes = (entries * MAX_NODES + MAX_FOLLOWER_POOL - 1) / MAX_FOLLOWER_POOL;
+    if (poolNodes > needed)
+        needed = poolNodes;
+
+    /* The saved text has a terminator per word, which the dictionary doesn't count */
+    words = ((textSize - wordCount) * MAX_DICT_WORDS + MAX_DICT_CHARS - 1) / MAX_DICT_CHARS;
+    if (words < wordCount)
+        words = wordCount;
+    wordNodes = (words * MAX_NODES + MAX_DICT_WORDS - 1) / MAX_DICT_WORDS;
+    if (wordNodes > needed)
+        needed = wordNodes;
+
+    return (needed > kMarkovMinNodes) ? needed : kMarkovMinNodes;
+}
+
+/* Follower pool entries a chain's followers take once loaded, spans exactly and a header each */
+static unsigned long LoadedPoolEntries(const MarkovChain *chain)
+{
+    unsigned long entries = 0;
+    short i;
+
+    for (i = 0; i < chain->nodeCount; i++) {
+        if (chain->nodes[i].followerCount > 0)
+            entries += 1 + chain->nodes[i].followerCount;
+    }
+    return entries;
+}
+
+/* Smallest maxNodes a chain needs to load a model, 0 if it isn't one */
+short MarkovChain_ModelCapacity(const unsigned char *data, long size)
+{
+    const unsigned char *end = data + size;
+    const unsigned char *p;
+    unsigned long entries = 0;
+    unsigned short nodeCount, followers;
+    long needed;
+    short i;
+
+    if (MarkovChain_ModelChecksum(data, size) == 0)
+        return 0;
+
+    nodeCount = GetShort(data + 8);
+    p         = data + MODEL_HEADER_SIZE + GetShort(data + 12) + 2L * GetShort(data + 10);
+    for (i = 0; i < nodeCount; i++) {
+        if (end - p < MODEL_NODE_SIZE)
+            return 0;
+        followers = p[5];
+        if (followers > 0)
+            entries += 1 + followers; /* Spans are loaded exactly, after a header entry */
+        p += MODEL_NODE_SIZE + MODEL_FOLLOWER_SIZE * followers;
+    }
+
+    needed = NeededNodes(nodeCount, entries, GetShort(data + 10), GetShort(data + 12));
+    return (needed <= kMarkovMaxNodes) ? needed : 0;
+}
+
+/* Smallest maxNodes a chain needs to load this one once saved, 0 if more than any chain has */
+short MarkovChain_Capacity(const MarkovChain *chain)
+{
+    long needed;
+
+    needed = NeededNodes(chain->nodeCount, LoadedPoolEntries(chain), SavedWordCount(chain),
+                         chain->sharedDictionary ? 0 : SavedTextSize(chain->dictionary));
+    return (needed <= kMarkovMaxNodes) ? needed : 0;
+}
+
+/* Number of bytes MarkovChain_Save needs for this chain */
+long MarkovChain_SavedSize(const MarkovChain *chain)
+{
+    long size = MODEL_HEADER_SIZE;
+    short i;
+
+    if (!chain->sharedDictionary)
+        size += SavedTextSize(chain->dictionary) + 2L * chain->dictionary->wordCount;
+    for (i = 0; i < chain->nodeCount; i++) {
+        size += MODEL_NODE_SIZE + MODEL_FOLLOWER_SIZE * chain->nodes[i].followerCount;
+    }
+    return size;
+}
+
+/* Write a chain in the compact model format, returns bytes written or 0 if it doesn't fit */
+long MarkovChain_Save(const MarkovChain *chain, unsigned char *buffer, long bufferSize)
+{
+    const MarkovDictionary *dict = chain->dictionary;
+    short wordCount              = SavedWordCount(chain);
+    unsigned char *p             = buffer;
+    short i, j;
+
+    if (bufferSize < MarkovChain_SavedSize(chain))
+        return 0;
+
+    /* Header */
+    p = PutShort(p, MODEL_MAGIC >> 16);
+    p = PutShort(p, MODEL_MAGIC & 0xFFFF);
+    p = PutShort(p, MODEL_VERSION);
+    *p++ = MODEL_COUNT_SIZE;
+    *p++ = chain->order;
+    p = PutShort(p, chain->nodeCount);
+    p = PutShort(p, wordCount);
+    p = PutShort(p, (wordCount > 0) ? SavedTextSize(dict) : 0);
+    p = PutLong(p, 0); /* Checksum, filled in once the rest is written */
+
+    /* Dictionary: the text of every word in ID order, then the normalized form of each */
+    for (i = 0; i < wordCount; i++) {
+        if (dict->wordOffset[i] == kFreeWordOffset) {
+            *p++ = '\0';
+        }
+        else {
+            strcpy((char *)p, WordText(dict, i));
+            p += strlen((char *)p) + 1;
+        }
+    }
+    for (i = 0; i < wordCount; i++) {
+        p = PutShort(p, (dict->wordOffset[i] != kFreeWordOffset) ? dict->wordNorm[i] : i);
+    }
+
+    /* Nodes with their followers */
+    for (i = 0; i < chain->nodeCount; i++) {
+        const MarkovNode *node            = &chain->nodes[i];
+        const WeightedFollower *followers = MarkovChain_Followers(chain, i);
+
+        p    = PutShort(p, node->parent);
+        p    = PutShort(p, node->word);
+        *p++ = node->order;
+        *p++ = node->followerCount;
+        for (j = 0; j < node->followerCount; j++) {
+            p = PutShort(p, followers[j].word);
+#if MODEL_COUNT_SIZE == 2
+            p = PutShort(p, followers[j].frequency);
+#else
+            *p++ = followers[j].frequency;
+#endif
+        }
+    }
+
+    PutLong(buffer + 14, Checksum(buffer + MODEL_HEADER_SIZE, p - buffer - MODEL_HEADER_SIZE));
+    return p - buffer;
+}
+
+/* Check that an ID names a word the dictionary holds */
+static Boolean IsLiveWord(const MarkovDictionary *dict, WordID id)
+{
+    return id < dict->wordCount && dict->wordOffset[id] != kFreeWordOffset;
+}
+
+/* Replace a dictionary with the one in a model, whose words are at text and their normalized
+ * forms at norms. Returns FALSE if it is invalid */
+static Boolean ReadDictionary(MarkovDictionary *dict, const unsigned char *text,
+                              unsigned short textSize, const unsigned char *norms,
+                              unsigned short wordCount)
+{
+    unsigned short offset = 0;
+    short i;
+
+    ClearDictionary(dict);
+
+    /* Copy the words in and rebuild the lookup table as we go */
+    for (i = 0; i < wordCount; i++) {
+        const char *word = (const char *)&text[offset];
+        size_t len;
+        short slot;
+
+        if (offset >= textSize || memchr(word, '\0', textSize - offset) == NULL)
+            return FALSE;
+        len = strlen(word) + 1;
+        offset += len;
+
+        dict->wordNorm[i] = GetShort(norms + 2 * i);
+        dict->wordCount   = i + 1;
+        if (dict->wordNorm[i] >= wordCount)
+            return FALSE;
+
+        /* IDs that were free when saved are stored as empty words */
+        if (len == 1) {
+            dict->wordOffset[i] = kFreeWordOffset;
+            dict->wordNorm[i]   = dict->freeWords;
+            dict->freeWords     = i;
+            continue;
+        }
+
+        if (dict->wordTextUsed + len > dict->maxWordChars)
+            return FALSE;
+        memcpy(&dict->wordText[dict->wordTextUsed], word, len);
+        dict->wordOffset[i] = dict->wordTextUsed;
+        dict->wordTextUsed += len;
+
+        slot                 = FindWordSlot(dict, word);
+        dict->wordHash[slot] = i;
+    }
+
+    /* The sentence markers must be where training put them */
+    if (!IsLiveWord(dict, kSentenceStart) || !IsLiveWord(dict, kSentenceEnd) ||
+        strcmp(WordText(dict, kSentenceStart), kSentenceStartText) != 0 ||
+        strcmp(WordText(dict, kSentenceEnd), kSentenceEndText) != 0)
+        return FALSE;
+    dict->wordRefs[kSentenceStart] = 1;
+    dict->wordRefs[kSentenceEnd]   = 1;
+
+    /* Normalized forms must be live words, and each one they stand for refers to them */
+    for (i = 0; i < wordCount; i++) {
+        WordID norm = dict->wordNorm[i];
+
+        if (dict->wordOffset[i] == kFreeWordOffset || norm == i)
+            continue;
+        if (dict->wordOffset[norm] == kFreeWordOffset)
+            return FALSE;
+        dict->wordRefs[norm]++;
+    }
+
+    /* A saved dictionary may hold words nothing uses, so let the next scan look */
+    dict->unusedWords = TRUE;
+    return TRUE;
+}
+
+/* Replace a chain with one read from the compact model format, returns FALSE if invalid */
+Boolean MarkovChain_Load(MarkovChain *chain, const unsigned char *data, long size)
+{
+    MarkovDictionary *dict   = chain->dictionary;
+    const unsigned char *p   = data;
+    const unsigned char *end = data + size;
+    unsigned short countSize, order, nodeCount, wordCount, textSize;
+    unsigned long total;
+    short i, j;
+
+    /* An empty chain is also what an invalid model leaves behind */
+    MarkovChain_Reset(chain);
+
+    /* Validate the header against our capacities before touching anything else */
+    if (size < MODEL_HEADER_SIZE || GetShort(p) != (MODEL_MAGIC >> 16) ||
+        GetShort(p + 2) != (MODEL_MAGIC & 0xFFFF) || GetShort(p + 4) != MODEL_VERSION ||
+        GetLong(p + 14) != Checksum(p + MODEL_HEADER_SIZE, size - MODEL_HEADER_SIZE))
+        return FALSE;
+
+    countSize = p[6];
+    order     = p[7];
+    nodeCount = GetShort(p + 8);
+    wordCount = GetShort(p + 10);
+    textSize  = GetShort(p + 12);
+    p += MODEL_HEADER_SIZE;
+
+    /* Only the chain that owns the dictionary saves it, and only that one loads it */
+    if (countSize != MODEL_COUNT_SIZE || order < 1 || order > MARKOV_ORDER ||
+        nodeCount > chain->maxNodes || wordCount > dict->maxWords ||
+        textSize > dict->maxWordChars + wordCount || end - p < textSize + 2L * wordCount ||
+        (wordCount == 0) != chain->sharedDictionary)
+        return FALSE;
+
+    if (wordCount > 0 && !ReadDictionary(dict, p, textSize, p + textSize, wordCount))
+        goto invalid;
+    p += textSize + 2L * wordCount;
+    chain->order = order;
+
+    /* Nodes: pack followers into the pool */
+    for (i = 0; i < nodeCount; i++) {
+        MarkovNode *node = &chain->nodes[i];
+        WeightedFollower *followers;
+
+        if (end - p < MODEL_NODE_SIZE)
+            goto invalid;
+
+        node->parent           = (short)GetShort(p);
+        node->word             = GetShort(p + 2);
+        node->order            = p[4] & kModelNodeOrderMask;
+        node->childCount       = 0;
+        node->sampleTableValid = FALSE;
+        node->recentlyUsed     = FALSE;
+        node->followerCount    = p[5];
+        p += MODEL_NODE_SIZE;
+
+        if (node->parent < -1 || node->parent >= (short)nodeCount ||
+            !IsLiveWord(dict, node->word) || node->order > order ||
+            end - p < MODEL_FOLLOWER_SIZE * node->followerCount ||
+            chain->followerPoolUsed + 1 + node->followerCount > chain->followerPoolSize)
+            goto invalid;
+
+        /* Spans are allocated exactly; training grows them as needed */
+        node->followerStart    = 0;
+        node->followerCapacity = node->followerCount;
+        if (node->followerCount > 0) {
+            chain->followerPool[chain->followerPoolUsed].word      = i;
+            chain->followerPool[chain->followerPoolUsed].frequency = node->followerCount;
+            node->followerStart = chain->followerPoolUsed + 1;
+            chain->followerPoolUsed += 1 + node->followerCount;
+        }
+
+        /* Sampling divides by the total, which must be positive and fit its table */
+        followers = &chain->followerPool[node->followerStart];
+        total     = 0;
+        for (j = 0; j < node->followerCount; j++) {
+            followers[j].word = GetShort(p);
+#if MODEL_COUNT_SIZE == 2
+            followers[j].frequency = GetShort(p + 2);
+#else
+            followers[j].frequency = p[2];
+#endif
+            p += MODEL_FOLLOWER_SIZE;
+            total += followers[j].frequency;
+            if (!IsLiveWord(dict, followers[j].word) || followers[j].frequency == 0 ||
+                total > kMaxFollowerTotal)
+                goto invalid;
+        }
+
+        chain->nodeCount = i + 1;
+    }
+
+    /* Eviction moves nodes, so parents can come after their children. Each context must be
+     * one word longer than its parent, which also rules out cycles */
+    for (i = 0; i < nodeCount; i++) {
+        MarkovNode *node = &chain->nodes[i];
+
+        if (node->order != ((node->parent >= 0) ? chain->nodes[node->parent].order + 1 : 1))
+            goto invalid;
+        if (node->parent >= 0)
+            chain->nodes[node->parent].childCount++;
+    }
+
+    /* Rebuild the state index and the keyword postings */
+    for (i = 0; i < nodeCount; i++) {
+        short slot = FindStateSlot(chain, chain->nodes[i].parent, chain->nodes[i].word);
+
+        if (chain->stateHash[slot] >= 0)
+            goto invalid; /* The same context twice */
+        chain->stateHash[slot] = i;
+        AddKeywordPostings(chain, i);
+    }
+
+    /* The model is sound, so its words can be counted as used. Loading shouldn't count towards
+     * the lookup statistics */
+    TakeChainWordRefs(chain);
+    memset(&chain->lookupStats, 0, sizeof(chain->lookupStats));
+    return TRUE;
+
+invalid:
+    chain->nodeCount = 0; /* No references were taken */
+    MarkovChain_Reset(chain);
+    return FALSE;
+}
@@ -0,0 +1,383 @@
+#ifndef MARKOV_CHAIN_H
+#define MARKOV_CHAIN_H
+
+/* The Markov chain core has no Toolbox dependencies so host tools can build it too */
+#include "portable.h"
+#include "random.h"
+#include "tokenizer.h"
+
+/* Variable-order Markov chain: contexts of 1 to MARKOV_ORDER words share storage in a trie */
+#ifndef MARKOV_ORDER
+#define MARKOV_ORDER 2 /* Quality/memory knob: each extra order costs a node per corpus word */
+#endif
+#define MARKOV_MAX_ORDER 4 /* Highest order the format and generator support */
+
+/* Chains are sized when created. These are the capacity the precompiled model is built with,
+ * and the proportions every other capacity keeps */
+#ifndef MAX_NODES
+#define MAX_NODES 2048 /* Contexts of all orders, about 50 bytes each with everything else */
+#endif
+#ifndef MAX_FOLLOWER_POOL
+#define MAX_FOLLOWER_POOL 6144 /* Shared follower storage, 6 bytes per entry with sampling */
+#endif
+#ifndef MAX_DICT_WORDS
+#define MAX_DICT_WORDS 3584 /* Distinct words; the static corpus has about 3200 */
+#endif
+#ifndef MAX_DICT_CHARS
+#define MAX_DICT_CHARS 28672 /* Shared storage for the text of all words, 8 bytes a word */
+#endif
+
+/* Limits of any chain: postings (node * MARKOV_ORDER) and hash sizes must fit in 16 bits */
+#define kMarkovMinNodes 256
+#define kMarkovMaxNodes 8191
+#if MAX_NODES < kMarkovMinNodes || MAX_NODES > kMarkovMaxNodes
+#error "MAX_NODES is out of range for this MARKOV_ORDER"
+#endif
+
+/* Limits of any dictionary: word text offsets, and the saved text with a byte per word, are
+ * 16-bit, and the word hash must stay within a short */
+#define kMarkovMaxWords 16383
+#define kMarkovMaxWordText 0xFFFEL
+#if MAX_DICT_WORDS < 64 || MAX_DICT_WORDS > kMarkovMaxWords
+#error "MAX_DICT_WORDS is out of range"
+#endif
+#if MAX_DICT_CHARS + MAX_DICT_WORDS > kMarkovMaxWordText
+#error "MAX_DICT_CHARS is out of range for MAX_DICT_WORDS"
+#endif
+
+/* Width of follower counts. A follower takes 4 bytes in memory either way (a word ID plus the
+ * count, padded), so 8 bits only makes the saved model smaller, at the cost of halving counts
+ * far more often as they grow */
+#ifndef MARKOV_COUNT_BITS
+#define MARKOV_COUNT_BITS 16
+#endif
+#if MARKOV_COUNT_BITS == 8
+typedef unsigned char FollowerCount;
+#define kMaxFollowerCount 0xFF
+#elif MARKOV_COUNT_BITS == 16
+typedef unsigned short FollowerCount;
+#define kMaxFollowerCount 0xFFFF
+#else
+#error "MARKOV_COUNT_BITS must be 8 or 16"
+#endif
+#define kMaxFollowerTotal 0xFFFFUL /* Counts of one context add up to at most this */
+
+#define MAX_FOLLOWERS 255  /* Most followers a single context can hold */
+#define MAX_WORD_LENGTH 24 /* Reduced slightly to save memory */
+
+#define kNoWord 0xFFFF         /* Marks an empty hash slot or a failed lookup */
+#define kFreeWordOffset 0xFFFF /* Word offset of a dictionary ID that is free for reuse */
+
+/* Sentence markers: reserved words before the first word of every sentence and after its last,
+ * trained like any other. Sentences start from the context of kSentenceStart alone and end when
+ * kSentenceEnd is picked as a follower. They have no text of their own */
+#define kSentenceStart 0
+#define kSentenceEnd 1
+
+/* Text of the sentence markers, for counting them like words. Training skips words starting
+ * with a control character, so no trained word can take their place */
+#define kSentenceStartText "\002"
+#define kSentenceEndText "\003"
+
+/* Follower sampling defaults */
+#define MARKOV_DEFAULT_TEMPERATURE 100 /* Percent; 100 samples the trained frequencies */
+#define MARKOV_DEFAULT_TOP_K 0         /* Most frequent followers to consider, 0 for all */
+#define kSampleWeightScale 255         /* Largest sampling weight when reshaped by temperature */
+#define kLogProbScale 16               /* Log probabilities are in sixteenths of a bit */
+
+/* Precompiled model resources, generated at build time by tools/markov_train. The general
+ * model carries the dictionary; the topic sub-models follow it, at MARKOV_MODEL_RES_ID + topic */
+#define MARKOV_MODEL_RES_TYPE 'MKVM'
+#define MARKOV_MODEL_RES_ID 128
+
+typedef unsigned short WordID;
+
+/* New: Weighted followers to improve text quality */
+typedef struct {
+    WordID word;             /* Interned ID of the following word */
+    FollowerCount frequency; /* How often this follower appeared, halved with its siblings */
+} WeightedFollower;
+
+/* A context of 1 to MARKOV_ORDER words. Contexts form a trie keyed from the most recent word
+ * back, so a node extends its parent's context with one older word and lower orders are shared */
+typedef struct {
+    short parent;                   /* Context one word shorter, -1 for single-word contexts */
+    WordID word;                    /* Oldest word; the newer ones come from the parents */
+    unsigned short followerStart;   /* First of this context's followers in the pool */
+    unsigned char followerCount;    /* Followers in use */
+    unsigned char followerCapacity; /* Pool entries reserved, 0 until the first follower */
+    unsigned short childCount;      /* Longer contexts extending this one */
+    unsigned char order : 3;            /* Number of words in the context */
+    unsigned char sampleTableValid : 1; /* Cumulative weights match the followers */
+    unsigned char recentlyUsed : 1;     /* Trained or sampled since the eviction hand passed */
+} MarkovNode;
+
+/* Check whether a context is the start of a sentence: its oldest word is kSentenceStart */
+#define MarkovChain_StartsSentence(chain, stateIndex) \
+    ((chain)->nodes[stateIndex].word == kSentenceStart)
+
+/* State lookup statistics, used to size the Markov state hash index */
+typedef struct {
+    unsigned long lookups;    /* Number of state lookups performed */
+    unsigned long probes;     /* Total index slots examined by those lookups */
+    unsigned short maxProbes; /* Longest single probe sequence */
+    short stateCount;         /* States currently stored in the chain */
+    short tableSize;          /* Number of slots in the hash index */
+} MarkovLookupStats;
+
+/* Contexts are counted by how many followers they have: none, then 1, 2-3, 4-7 and so on */
+#define kMarkovFollowerBuckets 9
+
+/* How full a chain is and how its contents are shaped, for sizing its capacity */
+typedef struct {
+    short nodeCount;
+    short maxNodes;
+    short nodesByOrder[MARKOV_MAX_ORDER];
+    short startNodes;     /* Contexts that start a sentence */
+    short saturatedNodes; /* Contexts with MAX_FOLLOWERS followers, which replace rare ones */
+    short followerHistogram[kMarkovFollowerBuckets];
+    long followers;               /* In all contexts */
+    short mostFollowers;          /* In any one context */
+    long saturatedCounts;         /* Followers at kMaxFollowerCount */
+    unsigned short countHalvings; /* Times a context's counts were halved to stay in range */
+    unsigned short poolUsed;      /* Follower pool entries, span headers and slack included */
+    unsigned short poolSize;
+    unsigned short poolPrunes;     /* Times the pool filled and rare followers were dropped */
+    unsigned short evictions;      /* Contexts forgotten to make room */
+    unsigned long droppedWords;    /* Training words the full dictionary couldn't take */
+    unsigned long droppedContexts; /* Training contexts the full chain couldn't take */
+    short wordCount;               /* Words in the dictionary */
+    short maxWords;
+    unsigned short wordChars; /* Characters of word text, terminators included */
+    unsigned short maxWordChars;
+    long memoryBytes; /* Of the chain's block, and its dictionary's if it owns it */
+    MarkovLookupStats lookup;
+} MarkovChainStats;
+
+/* Word dictionary. Words nothing refers to any more are reclaimed when it fills up. Several
+ * chains can share one, so their word IDs mean the same thing and the references of all of them
+ * count */
+typedef struct {
+    char *wordText;             /* NUL-terminated words */
+    unsigned short *wordOffset; /* Start of each word, kFreeWordOffset if free */
+    WordID *wordNorm;           /* ID of the lowercase form, or next free ID */
+    unsigned short *wordRefs;   /* Nodes, followers and words referring to it */
+    WordID *wordHash;           /* Open-addressed word lookup */
+    unsigned short wordHashMask;
+    short wordCount; /* IDs handed out, including free ones */
+    short maxWords;
+    unsigned short wordTextUsed;
+    unsigned short maxWordChars;
+    WordID freeWords; /* First reclaimed ID, kNoWord if none */
+    Boolean unusedWords; /* Some word may have lost its last reference since the last scan */
+} MarkovDictionary;
+
+/* A complete chain: contexts, their index and the word dictionary they refer to. The arrays
+ * live in the same block as the chain, laid out by MarkovChain_Init, and so does the dictionary
+ * unless the chain shares another chain's */
+typedef struct {
+    MarkovNode *nodes;
+    short nodeCount;
+    short maxNodes;
+    short order; /* Longest context trained, 1 to MARKOV_MAX_ORDER */
+
+    /* Online learning: when full, forget a context the clock hand finds unused since its last
+     * pass. Only leaves are evicted, so every remaining context keeps its shorter parents */
+    Boolean evictWhenFull;
+    short evictionHand;
+    unsigned short evictions; /* Contexts forgotten to make room */
+
+    /* Training words the full dictionary couldn't take, each time one came up. Training goes
+     * on past them, but leaves a gap where they were */
+    unsigned long droppedWords;
+
+    /* Training contexts the full chain couldn't take, each time one came up, when it doesn't
+     * evict. Their followers are lost, and those of the longer contexts ending in them */
+    unsigned long droppedContexts;
+
+    /* State index and its probe statistics; at least twice as many slots as nodes keeps the
+     * load factor at or below 0.5 */
+    short *stateHash; /* Node index per slot, -1 when empty */
+    short stateHashBits;
+    MarkovLookupStats lookupStats;
+
+    /* Inverted index from normalized word to the contexts containing it. A posting is
+     * node * MARKOV_ORDER + depth, where depth counts parents up to the word's position */
+    short *keywordHead; /* First posting per normalized word, or -1 */
+    short *keywordNext; /* Next posting for the same word, or -1 */
+
+    /* Follower lists of all nodes, as spans each preceded by a header entry whose word is the
+     * owning node (kNoWord once abandoned) and whose frequency is the span's capacity */
+    WeightedFollower *followerPool;
+    unsigned short followerPoolSize;
+    unsigned short followerPoolUsed;
+    unsigned short followerPoolPrunes; /* Times the pool filled and rare followers were dropped */
+    Boolean followerPoolSaturated;     /* Pruning stopped helping; new followers evict rare ones */
+    unsigned short countHalvings;      /* Times a context's counts were halved to stay in range */
+
+    /* Cumulative follower weights parallel to the pool, built lazily when sampling */
+    unsigned short *sampleTable;
+    short temperature; /* Percent; lower favors frequent followers, higher flattens */
+    short topK;        /* Most frequent followers to consider, 0 for all */
+
+    MarkovDictionary *dictionary;
+    Boolean sharedDictionary; /* The dictionary belongs to another chain */
+
+    RandomStream random; /* Drives follower replacement when a context is full */
+} MarkovChain;
+
+/* Bytes a chain with room for maxNodes contexts needs, everything included */
+long MarkovChain_StorageSize(short maxNodes);
+
+/* Set up an empty chain in a block of MarkovChain_StorageSize(maxNodes) bytes, which must be
+ * aligned for a pointer. The other capacities keep the proportions of the defaults */
+MarkovChain *MarkovChain_Init(void *storage, short maxNodes);
+
+/* Bytes a chain sharing a dictionary of maxWords words needs, dictionary not included */
+long MarkovChain_SharedStorageSize(short maxNodes, short maxWords);
+
+/* Set up an empty chain sharing another chain's dictionary, in a block of
+ * MarkovChain_SharedStorageSize(maxNodes, dictionary->maxWords) bytes. Topic sub-models share
+ * the general model's dictionary this way, so their word IDs can be mixed freely */
+MarkovChain *MarkovChain_InitShared(void *storage, short maxNodes, MarkovDictionary *dictionary);
+
+/* Empty a chain, ready for training. A chain sharing its dictionary gives back its references to
+ * the words, so it can be disposed of afterwards; one that owns it starts a new dictionary */
+void MarkovChain_Reset(MarkovChain *chain);
+
+/* Hold a reference to every word with an ID below count, so none of them is ever reclaimed.
+ * Sub-models that share the dictionary but aren't loaded keep their words this way */
+void MarkovChain_HoldWords(MarkovChain *chain, short count);
+
+/* Train a chain with new text, counting followers for every context order */
+void MarkovChain_Train(MarkovChain *chain, const char *text);
+
+/* Train a chain with text that is already split into tokens, such as a prompt every engine
+ * shares. Trains exactly what MarkovChain_Train would on the same text */
+void MarkovChain_TrainTokens(MarkovChain *chain, const TokenList *tokens);
+
+/* Get the length of a word of training text once punctuation other than sentence enders is
+ * cut from its end, and set whether it ends a sentence. Returns 0 for a word training skips */
+short MarkovChain_CleanWordLength(const char *word, short length, Boolean *isEndOfSentence);
+
+/* Add count to a follower of the context of order words, newest first, adding the words and the
+ * context as needed, to build a chain from transitions counted elsewhere. Counts past the
+ * limits are halved as in training. Returns FALSE if the chain has no room for them */
+Boolean MarkovChain_AddCount(MarkovChain *chain, const char *const *context, short order,
+                             const char *follower, unsigned short count);
+
+/* Take back what training the same text added, forgetting contexts and followers it leaves
+ * with no counts. Exact unless the counts were halved or pruned in between, in which case
+ * whatever is left of them goes instead */
+void MarkovChain_Untrain(MarkovChain *chain, const char *text);
+
+/* Drop followers seen fewer than minCount times from contexts of minOrder words or more, then
+ * the contexts left with no followers and no longer contexts, and the words nothing uses any
+ * more. Returns the number of contexts removed */
+short MarkovChain_Prune(MarkovChain *chain, unsigned short minCount, short minOrder);
+
+/* Prune with a rising minimum count, longest contexts first, until the saved chain fits in
+ * maxSavedSize bytes or nothing is left to prune. Returns the saved size reached */
+long MarkovChain_PruneToSize(MarkovChain *chain, long maxSavedSize);
+
+/* Forget the least trained contexts, longest first, until a chain of maxNodes has room for the
+ * contexts and followers left, to shrink a model on purpose to what a smaller chain can load.
+ * The dictionary keeps its words. Returns MarkovChain_Capacity of what is left */
+short MarkovChain_PruneToCapacity(MarkovChain *chain, short maxNodes);
+
+/* Let training forget least recently used contexts when the chain is full, instead of
+ * refusing new ones. Off after a reset, so a fixed corpus trains the same way every time */
+void MarkovChain_SetEviction(MarkovChain *chain, Boolean evictWhenFull);
+
+/* Find the context extending parent (-1 for none) with an older word, returns index or -1 */
+short MarkovChain_FindState(MarkovChain *chain, short parent, WordID word);
+
+/* Find the longest context of recent words (newest first) that has followers, backing off to
+ * shorter contexts as needed, returns index or -1 if even the last word has no followers */
+short MarkovChain_FindContext(MarkovChain *chain, const WordID *recentWords, short count);
+
+/* Get the words of a context, oldest first, returns the number of words */
+short MarkovChain_GetContextWords(const MarkovChain *chain, short stateIndex, WordID *words);
+
+/* Change the sampling temperature (percent) and top-k, invalidating the sampling tables */
+void MarkovChain_SetSampling(MarkovChain *chain, short temperature, short topK);
+
+/* Pick a follower of a state by weight, drawing from random, returns kNoWord if the state has
+ * none */
+WordID MarkovChain_SampleFollower(MarkovChain *chain, short stateIndex, RandomStream *random);
+
+/* Pick a follower like MarkovChain_SampleFollower, also setting logProb to the log2 probability
+ * of the pick in kLogProbScale units (0 or less). Summed over a reply, this scores how likely
+ * the chain finds it */
+WordID MarkovChain_SampleFollowerScored(MarkovChain *chain, short stateIndex,
+                                        RandomStream *random, short *logProb);
+
+/* Get up to max of a state's followers, most likely first under the current temperature and
+ * top-k, with the log2 probability of each in kLogProbScale units. Returns how many */
+short MarkovChain_LikelyFollowers(MarkovChain *chain, short stateIndex, short max, WordID *words,
+                                  short *logProbs);
+
+/* Get the sampling weight of one of a state's followers under the current temperature and top-k,
+ * and the total weight of all of them. Returns 0 if the state doesn't sample that word */
+unsigned short MarkovChain_FollowerWeight(MarkovChain *chain, short stateIndex, WordID word,
+                                          unsigned short *total);
+
+/* log2 of a positive value in kLogProbScale units, to within a unit */
+short MarkovChain_Log2(unsigned long value);
+
+/* Get the followers of a state; there are nodes[stateIndex].followerCount of them */
+const WeightedFollower *MarkovChain_Followers(const MarkovChain *chain, short stateIndex);
+
+/* First posting of a context containing a normalized word, -1 if there are none */
+short MarkovChain_FirstPosting(const MarkovChain *chain, WordID keyword);
+
+/* Next posting for the same normalized word, -1 at the end of the list */
+short MarkovChain_NextPosting(const MarkovChain *chain, short posting);
+
+/* The context a posting refers to */
+#define MarkovChain_PostingState(posting) ((posting) / MARKOV_ORDER)
+
+/* Look up a word in the dictionary, returns its ID or kNoWord if unknown */
+WordID MarkovChain_FindWord(const MarkovChain *chain, const char *word);
+
+/* Look up the normalized (lowercase, unpunctuated) ID of a keyword */
+WordID MarkovChain_FindKeyword(const MarkovChain *chain, const char *keyword);
+
+/* Get the text of an interned word */
+const char *MarkovChain_WordText(const MarkovChain *chain, WordID id);
+
+/* Get state lookup statistics for sizing the hash index */
+void MarkovChain_GetLookupStats(const MarkovChain *chain, MarkovLookupStats *stats);
+
+/* Get how full a chain is and the shape of its contents. Walks every context, so it is for
+ * tuning and debugging rather than every reply */
+void MarkovChain_GetStats(const MarkovChain *chain, MarkovChainStats *stats);
+
+/* Number of bytes MarkovChain_Save needs for this chain */
+long MarkovChain_SavedSize(const MarkovChain *chain);
+
+/* Write a chain in the compact model format, returns bytes written or 0 if it doesn't fit. The
+ * dictionary is only written by the chain that owns it */
+long MarkovChain_Save(const MarkovChain *chain, unsigned char *buffer, long bufferSize);
+
+/* Replace a chain with one read from the compact model format, returns FALSE if invalid. A chain
+ * that owns its dictionary replaces that too, so any chain sharing it must be reset first; one
+ * sharing a dictionary loads a model saved without one, from a chain that shared the same */
+Boolean MarkovChain_Load(MarkovChain *chain, const unsigned char *data, long size);
+
+/* Smallest maxNodes a chain needs to load a model, from walking its structure without checking
+ * it, 0 if it isn't a model. Sub-models are given no more room than this, as they don't learn */
+short MarkovChain_ModelCapacity(const unsigned char *data, long size);
+
+/* Smallest maxNodes a chain needs to load this one once it is saved, counting its contexts,
+ * followers and the dictionary it saves, 0 if that is more than any chain has */
+short MarkovChain_Capacity(const MarkovChain *chain);
+
+/* Number of dictionary words a model carries, from its header alone, 0 if it isn't a model */
+short MarkovChain_ModelWords(const unsigned char *data, long size);
+
+/* Get the checksum stored in a model's header without checking the rest, 0 if not a model.
+ * Cheap enough to tell whether a saved chain was built from a given model */
+unsigned long MarkovChain_ModelChecksum(const unsigned char *data, long size);
+
+#endif /* MARKOV_CHAIN_H */
@@ -1,10 +1,25 @@
 #ifndef MARKOV_DATA_H
 #define MARKOV_DATA_H
 
+#include "markov_topic.h"
+
 /* Load static training data into the Markov model */
 void LoadStaticTrainingData(void);
 
-/* Load dynamic system-specific training data into the Markov model */
+/* Number of entries (sentences or short passages) in the static training data */
+short StaticTrainingCount(void);
+
+/* Get the text of a static entry, 0 to StaticTrainingCount() - 1, and set topic (if not NULL)
+ * to the topic it belongs to. The topics take turns, so any first part of the corpus has some of
+ * each */
+const char *StaticTrainingEntry(short entry, MarkovTopic *topic);
+
+/* Train up to count static entries starting at first, returns the entry to continue from.
+ * Training the corpus a slice at a time gives the same chain as training it all at once */
+short LoadStaticTrainingSlice(short first, short count);
+
+/* Load dynamic system-specific training data into the Markov model, as volatile facts that are
+ * replaced when they are refreshed */
 void LoadDynamicTrainingData(void);
 
 /* Load all training data into the Markov model */
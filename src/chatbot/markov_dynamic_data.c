@@ -0,0 +1,129 @@
+#include <Gestalt.h>
+#include <Memory.h>
+#include <OSUtils.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "../constants.h"
+#include "markov.h"
+#include "markov_data.h"
+
+/* Load all training data into the Markov model */
+void LoadTrainingData(void)
+{
+    /* Load static training data */
+    LoadStaticTrainingData();
+
+    /* Load dynamic system-specific training data */
+    LoadDynamicTrainingData();
+}
+
+/* Load dynamic system-specific training data, as facts the chain can untrain when refreshing */
+void LoadDynamicTrainingData(void)
+{
+    DateTimeRec dateTime;
+    GetTime(&dateTime);
+
+    /* Buffer for formatted messages */
+    char buffer[256];
+
+    /* Time-related responses - Dynamically generated based on actual system data */
+    /* Current month and year based on actual system date */
+    const char *monthNames[] = {"January",   "February", "March",    "April",
+                                "May",       "June",     "July",     "August",
+                                "September", "October",  "November", "December"};
+    sprintf(buffer, "The current month is %s %d.", monthNames[dateTime.month - 1], dateTime.year);
+    TrainMarkovFact(buffer);
+
+    /* Current time based on actual system time */
+    sprintf(buffer, "The current time is %d:%02d.", dateTime.hour, dateTime.minute);
+    TrainMarkovFact(buffer);
+
+    /* Current date based on actual system date */
+    sprintf(buffer, "Today is %s %d, %d.", monthNames[dateTime.month - 1], dateTime.day,
+            dateTime.year);
+    TrainMarkovFact(buffer);
+
+    /* Memory information using Gestalt for physical RAM */
+    long physicalRAM;
+    if (Gestalt(gestaltPhysicalRAMSize, &physicalRAM) == noErr) {
+        /* Format as MB with 1 decimal place */
+        float ramMB = (float)physicalRAM / (1024 * 1024);
+
+        sprintf(buffer, "Your Mac has about %.1f MB of RAM installed.", ramMB);
+        TrainMarkovFact(buffer);
+
+        sprintf(buffer, "This Mac has %.1f megabytes of RAM.", ramMB);
+        TrainMarkovFact(buffer);
+
+        sprintf(buffer, "Your system has %.1f MB of memory.", ramMB);
+        TrainMarkovFact(buffer);
+    }
+    else {
+        /* Fallback if Gestalt fails */
+        sprintf(buffer, "Your Mac has about 4 MB of RAM installed.");
+        TrainMarkovFact(buffer);
+
+        sprintf(buffer, "This Mac has 4 megabytes of RAM.");
+        TrainMarkovFact(buffer);
+
+        sprintf(buffer, "Your system has 4MB of memory.");
+        TrainMarkovFact(buffer);
+    }
+
+    long freeMem = FreeMem();
+    if (freeMem > 0) {
+        sprintf(buffer, "You have around %.1f MB of free memory available right now.",
+                (float)freeMem / (1024 * 1024));
+        TrainMarkovFact(buffer);
+    }
+
+    /* System version from Gestalt */
+    long sysVersion;
+    if (Gestalt(gestaltSystemVersion, &sysVersion) == noErr) {
+        short majorVersion = (sysVersion >> 8) & 0xFF;
+        short minorVersion = sysVersion & 0xFF;
+        sprintf(buffer, "You're running System %d.%d on your Mac.", majorVersion, minorVersion);
+        TrainMarkovFact(buffer);
+    }
+
+    /* CPU type from Gestalt */
+    long cpuType;
+    if (Gestalt(gestaltProcessorType, &cpuType) == noErr) {
+        const char *cpuName = "unknown";
+        switch (cpuType) {
+        case gestalt68000:
+            cpuName = "Motorola 68000";
+            break;
+        case gestalt68010:
+            cpuName = "Motorola 68010";
+            break;
+        case gestalt68020:
+            cpuName = "Motorola 68020";
+            break;
+        case gestalt68030:
+            cpuName = "Motorola 68030";
+            break;
+        case gestalt68040:
+            cpuName = "Motorola 68040";
+            break;
+        }
+        sprintf(buffer, "Your Mac has a %s processor.", cpuName);
+        TrainMarkovFact(buffer);
+    }
+
+    /* System uptime from tick count */
+    unsigned long ticks   = TickCount();
+    unsigned long seconds = ticks / 60; /* 60 ticks per second */
+    unsigned long minutes = seconds / 60;
+    unsigned long hours   = minutes / 60;
+    minutes %= 60;
+
+    if (hours > 0) {
+        sprintf(buffer, "Your Mac has been running for %lu hours and %lu minutes.", hours, minutes);
+    }
+    else {
+        sprintf(buffer, "Your Mac has been running for %lu minutes.", minutes);
+    }
+    TrainMarkovFact(buffer);
+}
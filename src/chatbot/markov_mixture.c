@@ -0,0 +1,178 @@
+#include <stddef.h>
+
+#include "markov_mixture.h"
+
+/* Probabilities are mixed as fractions of 1 << kProbabilityBits; times a weight of at most 100
+ * for each of kMaxMixtureChains chains, the sum stays well within a long */
+#define kProbabilityBits 16
+
+/* Start an empty mixture */
+void MarkovMixture_Init(MarkovMixture *mixture)
+{
+    mixture->count = 0;
+}
+
+/* Add a chain with a weight of 1 to 100, returns FALSE if the mixture is full */
+Boolean MarkovMixture_Add(MarkovMixture *mixture, MarkovChain *chain, short weight)
+{
+    if (mixture->count == kMaxMixtureChains)
+        return FALSE;
+
+    if (weight < 1)
+        weight = 1;
+    if (weight > 100)
+        weight = 100;
+    mixture->chains[mixture->count]    = chain;
+    mixture->weights[mixture->count++] = weight;
+    return TRUE;
+}
+
+/* Find each chain's context for the recent words, -1 where it has none, returns how many have
+ * one and the total weight of those */
+static short FindContexts(MarkovMixture *mixture, const WordID *recentWords, short recentCount,
+                          short *states, unsigned long *weightTotal)
+{
+    short found = 0;
+    short i;
+
+    *weightTotal = 0;
+    for (i = 0; i < mixture->count; i++) {
+        states[i] = MarkovChain_FindContext(mixture->chains[i], recentWords, recentCount);
+        if (states[i] >= 0) {
+            *weightTotal += mixture->weights[i];
+            found++;
+        }
+    }
+    return found;
+}
+
+/* Check whether any chain has followers for the recent words */
+Boolean MarkovMixture_HasContext(MarkovMixture *mixture, const WordID *recentWords,
+                                 short recentCount)
+{
+    short states[kMaxMixtureChains];
+    unsigned long weightTotal;
+
+    return FindContexts(mixture, recentWords, recentCount, states, &weightTotal) > 0;
+}
+
+/* Probability of a word summed over the chains with a context, each times its weight */
+static unsigned long MixedProbability(MarkovMixture *mixture, const short *states, WordID word)
+{
+    unsigned long mixed = 0;
+    unsigned short weight, total;
+    short i;
+
+    for (i = 0; i < mixture->count; i++) {
+        if (states[i] < 0)
+            continue;
+        weight = MarkovChain_FollowerWeight(mixture->chains[i], states[i], word, &total);
+        if (weight > 0)
+            mixed += mixture->weights[i] * (((unsigned long)weight << kProbabilityBits) / total);
+    }
+    return mixed;
+}
+
+/* log2 of a mixed probability, dividing out the weights it was summed with */
+static short MixedLogProb(unsigned long mixed, unsigned long weightTotal)
+{
+    return MarkovChain_Log2(mixed) - MarkovChain_Log2(weightTotal << kProbabilityBits);
+}
+
+/* Pick a follower of the recent words by its mixed probability */
+WordID MarkovMixture_SampleFollower(MarkovMixture *mixture, const WordID *recentWords,
+                                    short recentCount, RandomStream *random, short *logProb)
+{
+    short states[kMaxMixtureChains];
+    unsigned long weightTotal, draw;
+    short found, i;
+    WordID word;
+
+    found = FindContexts(mixture, recentWords, recentCount, states, &weightTotal);
+    if (found == 0)
+        return kNoWord;
+
+    i = 0;
+    while (states[i] < 0) {
+        i++;
+    }
+    if (found == 1)
+        return MarkovChain_SampleFollowerScored(mixture->chains[i], states[i], random, logProb);
+
+    /* Picking a chain by weight and then a follower from it draws from the mixture */
+    draw = Random_Below(random, weightTotal);
+    while (states[i] < 0 || draw >= (unsigned long)mixture->weights[i]) {
+        if (states[i] >= 0)
+            draw -= mixture->weights[i];
+        i++;
+    }
+
+    word = MarkovChain_SampleFollowerScored(mixture->chains[i], states[i], random, NULL);
+    if (logProb != NULL)
+        *logProb = MixedLogProb(MixedProbability(mixture, states, word), weightTotal);
+    return word;
+}
+
+/* Get the most likely followers of the recent words under the mixture */
+short MarkovMixture_LikelyFollowers(MarkovMixture *mixture, const WordID *recentWords,
+                                    short recentCount, short max, WordID *words,
+                                    short *logProbs)
+{
+    WordID candidates[kMaxMixtureChains * kMaxMixtureFollowers];
+    unsigned long mixed[kMaxMixtureChains * kMaxMixtureFollowers];
+    WordID chainWords[kMaxMixtureFollowers];
+    short chainLogProbs[kMaxMixtureFollowers];
+    short states[kMaxMixtureChains];
+    unsigned long weightTotal, entryMixed;
+    short found, count = 0, got, i, j, k;
+    WordID entry;
+
+    if (max > kMaxMixtureFollowers)
+        max = kMaxMixtureFollowers;
+
+    found = FindContexts(mixture, recentWords, recentCount, states, &weightTotal);
+    if (found == 0)
+        return 0;
+
+    i = 0;
+    while (states[i] < 0) {
+        i++;
+    }
+    if (found == 1)
+        return MarkovChain_LikelyFollowers(mixture->chains[i], states[i], max, words, logProbs);
+
+    /* The likeliest followers under the mixture are almost always among the likeliest of one
+     * of the chains, so only those are scored, each once */
+    for (; i < mixture->count; i++) {
+        if (states[i] < 0)
+            continue;
+        got = MarkovChain_LikelyFollowers(mixture->chains[i], states[i], max, chainWords,
+                                          chainLogProbs);
+        for (j = 0; j < got; j++) {
+            for (k = 0; k < count && candidates[k] != chainWords[j]; k++)
+                ;
+            if (k == count)
+                candidates[count++] = chainWords[j];
+        }
+    }
+
+    /* Most likely first; ties keep the order the chains were added in */
+    for (i = 0; i < count; i++) {
+        entry      = candidates[i];
+        entryMixed = MixedProbability(mixture, states, entry);
+        for (j = i; j > 0 && mixed[j - 1] < entryMixed; j--) {
+            candidates[j] = candidates[j - 1];
+            mixed[j]      = mixed[j - 1];
+        }
+        candidates[j] = entry;
+        mixed[j]      = entryMixed;
+    }
+
+    if (count > max)
+        count = max;
+    for (i = 0; i < count; i++) {
+        words[i]    = candidates[i];
+        logProbs[i] = MixedLogProb(mixed[i], weightTotal);
+    }
+    return count;
+}
@@ -0,0 +1,42 @@
+#ifndef MARKOV_MIXTURE_H
+#define MARKOV_MIXTURE_H
+
+#include "markov_chain.h"
+
+/* Interpolation of chains sharing one dictionary, such as the general model and the topic
+ * sub-models a prompt is routed to. The probability of a follower is the weighted mean of its
+ * probability in each chain that knows the recent words; chains that don't sit out, and the
+ * others share their weight. Log probabilities are fixed point, as from the chain */
+#define kMaxMixtureChains 3    /* The general model and two topics */
+#define kMaxMixtureFollowers 8 /* Most followers MarkovMixture_LikelyFollowers returns */
+
+typedef struct {
+    MarkovChain *chains[kMaxMixtureChains];
+    short weights[kMaxMixtureChains]; /* Relative to each other, at most 100 */
+    short count;
+} MarkovMixture;
+
+/* Start an empty mixture */
+void MarkovMixture_Init(MarkovMixture *mixture);
+
+/* Add a chain with a weight of 1 to 100, returns FALSE if the mixture is full. Chains are
+ * searched in the order added wherever one has to be picked, such as for a starting context */
+Boolean MarkovMixture_Add(MarkovMixture *mixture, MarkovChain *chain, short weight);
+
+/* Check whether any chain has followers for the recent words (newest first) */
+Boolean MarkovMixture_HasContext(MarkovMixture *mixture, const WordID *recentWords,
+                                 short recentCount);
+
+/* Pick a follower of the recent words (newest first) by its mixed probability, drawing from
+ * random, and set logProb to its log2. Returns kNoWord if no chain knows the recent words. A
+ * single chain samples exactly as MarkovChain_SampleFollowerScored would */
+WordID MarkovMixture_SampleFollower(MarkovMixture *mixture, const WordID *recentWords,
+                                    short recentCount, RandomStream *random, short *logProb);
+
+/* Get up to max of the most likely followers of the recent words under the mixture, with the
+ * log2 of their mixed probabilities. Returns how many, 0 if no chain knows the recent words */
+short MarkovMixture_LikelyFollowers(MarkovMixture *mixture, const WordID *recentWords,
+                                    short recentCount, short max, WordID *words,
+                                    short *logProbs);
+
+#endif /* MARKOV_MIXTURE_H */
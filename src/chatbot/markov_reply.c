@@ -0,0 +1,510 @@
+#include <string.h>
+
+#include "markov_beam.h"
+#include "markov_reply.h"
+#include "reply_budget.h"
+#include "text_builder.h"
+
+/* Best score FindRelevantStartingState can give, so it can stop looking */
+#define kMaxRelevanceScore 4
+#define kNotSearched -2 /* Relevant start state not looked up yet */
+
+/* Candidate scoring */
+#define kMaxReplyKeywords 8                /* Prompt words a candidate is scored on */
+#define kKeywordBonus (3 * kLogProbScale)  /* A prompt word is worth 3 bits per word */
+#define kRepeatPenalty (8 * kLogProbScale) /* A reply of nothing but repeats loses 8 bits */
+#define kSeenWordBits 256                  /* Words remembered for spotting repeats */
+
+#ifndef MARKOV_BEAM_LENGTH_PENALTY
+#define MARKOV_BEAM_LENGTH_PENALTY 70 /* Percent, 0 favors short sentences, 100 is neutral */
+#endif
+
+/* Beam search working storage, so decoding never allocates */
+static MarkovBeamPool gBeamPool;
+
+/* Remember a generated word as the newest of the recent words */
+static void PushRecentWord(WordID *recentWords, short *recentCount, WordID word)
+{
+    short i;
+
+    for (i = (*recentCount < MARKOV_MAX_ORDER) ? *recentCount : MARKOV_MAX_ORDER - 1; i > 0; i--) {
+        recentWords[i] = recentWords[i - 1];
+    }
+    recentWords[0] = word;
+    if (*recentCount < MARKOV_MAX_ORDER)
+        (*recentCount)++;
+}
+
+/* Generation state shared by the engine and its strategy hooks */
+typedef struct MarkovGenerator MarkovGenerator;
+
+/* Strategy hooks: how a reply starts, how each next word is chosen and when the reply ends */
+typedef void (*MarkovStartProc)(MarkovGenerator *gen);
+typedef WordID (*MarkovSampleProc)(MarkovGenerator *gen);
+typedef Boolean (*MarkovStopProc)(const MarkovGenerator *gen);
+
+struct MarkovGenerator {
+    MarkovStartProc start;
+    MarkovSampleProc sample;
+    MarkovStopProc shouldStop;
+    const TokenList *prompt; /* User message the start strategy may draw on, or NULL */
+    MarkovMixture mixture;   /* The chains replied from, in the order starts are looked for */
+    MarkovChain *words;      /* Any of them, for the dictionary they share */
+    RandomStream *random;
+    short beamWidth; /* 1 to sample */
+
+    TextBuilder text;
+    WordID recentWords[MARKOV_MAX_ORDER]; /* Newest first */
+    short recentCount;
+    short wordCount;
+    short sentenceTarget;
+    short relevantState;        /* Start found for the prompt, kept across candidates */
+    MarkovChain *relevantChain; /* Chain the relevant start is in */
+    short candidate;            /* Candidates generated before this one */
+
+    /* Scoring: normalized prompt words the reply used, and how likely the chain found it */
+    WordID keywords[kMaxReplyKeywords];
+    short keywordCount;
+    unsigned short keywordHits; /* Bit per keyword used */
+    long logProb;               /* Sum over sampled words, in kLogProbScale units */
+    short sampledWords;
+    short repeatedWords; /* Likely loops score well on probability alone, so count repeats */
+    unsigned char seenWords[kSeenWordBits / 8];
+
+    /* Beam decoding: the rest of the sentence decoded so far, handed out a word at a time */
+    WordID beamWords[kMaxBeamWords];
+    short beamLogProbs[kMaxBeamWords];
+    short beamCount;
+    short beamNext;
+};
+
+/* Append a word to the reply, noting any prompt keyword it matches */
+static void EmitWord(MarkovGenerator *gen, WordID word)
+{
+    WordID norm = gen->words->dictionary->wordNorm[word];
+    short bit   = norm % kSeenWordBits;
+    short i;
+
+    /* The start marker is context for what follows, but has no text of its own */
+    PushRecentWord(gen->recentWords, &gen->recentCount, word);
+    if (word == kSentenceStart)
+        return;
+
+    TextBuilder_AppendWord(&gen->text, MarkovChain_WordText(gen->words, word));
+    gen->wordCount++;
+
+    /* Different words sharing a bit count as repeats too, which only costs a little score */
+    if (gen->seenWords[bit >> 3] & (1 << (bit & 7)))
+        gen->repeatedWords++;
+    gen->seenWords[bit >> 3] |= 1 << (bit & 7);
+
+    for (i = 0; i < gen->keywordCount; i++) {
+        if (gen->keywords[i] == norm)
+            gen->keywordHits |= 1 << i;
+    }
+}
+
+/* Append all words of a chain's state to the reply and restart the recent words from them */
+static void BeginWithState(MarkovGenerator *gen, MarkovChain *chain, short stateIndex)
+{
+    WordID words[MARKOV_MAX_ORDER];
+    short count = MarkovChain_GetContextWords(chain, stateIndex, words);
+    short i;
+
+    gen->recentCount = 0;
+    gen->beamCount   = 0; /* A decoded sentence doesn't carry over to a new start */
+    for (i = 0; i < count; i++) {
+        EmitWord(gen, words[i]);
+    }
+}
+
+/* Start a sentence from the start marker, so its first word is sampled like any other */
+static void BeginSentence(MarkovGenerator *gen)
+{
+    gen->recentCount = 0;
+    gen->beamCount   = 0;
+    EmitWord(gen, kSentenceStart);
+}
+
+/* Words long enough to pass for topic words that still say nothing about the topic */
+static const char *const kCommonWords[] = {"this",  "that",  "with", "from", "what", "when",
+                                           "where", "which", "have", "your", NULL};
+
+/* Check if a prompt word says what it is about, rather than being very short or common */
+static Boolean IsTopicWord(const TokenList *prompt, const Token *token)
+{
+    return token->keyLength >= 4 && !Tokenizer_KeyIn(prompt, token, kCommonWords);
+}
+
+/* Look up the normalized ID of a prompt word */
+static WordID FindTokenKeyword(const MarkovChain *chain, const TokenList *prompt,
+                               const Token *token)
+{
+    char key[MAX_WORD_LENGTH];
+
+    Tokenizer_CopyKey(prompt, token, key, sizeof(key));
+    return MarkovChain_FindWord(chain, key);
+}
+
+/* Check whether a prompt has a word, compared by key so "How?" has "how" but "show" doesn't */
+static Boolean PromptHasWord(const TokenList *prompt, const char *word)
+{
+    short i;
+
+    for (i = 0; i < prompt->count; i++) {
+        if (Tokenizer_KeyIs(prompt, &prompt->tokens[i], word))
+            return TRUE;
+    }
+    return FALSE;
+}
+
+/* Find a good starting state of a chain based on user query keywords, returns -1 if nothing
+ * matches */
+static short FindRelevantStartingState(MarkovChain *chain, const TokenList *prompt)
+{
+    short i, j, bestIndex = -1;
+    short relevanceScore = 0;
+    short bestScore      = 0;
+    short posting;
+    WordID keyword;
+    const Token *token;
+    const char *keywords[] = {"science",  "computer", "mac",     "help",  "what",
+                              "how",      "why",      "health",  "time",  "digital",
+                              "creative", "learn",    "think",   "music", "art",
+                              "history",  "code",     "program", "system"};
+    short keywordCount     = sizeof(keywords) / sizeof(keywords[0]);
+
+    /* If no user message or very short, there's nothing to match */
+    if (!prompt || strlen(prompt->text) < 4) {
+        return -1;
+    }
+
+    /* First check for exact matches with the predefined keywords */
+    for (i = 0; i < keywordCount; i++) {
+        if (PromptHasWord(prompt, keywords[i])) {
+            /* Words that were never trained can't appear in any state */
+            keyword = MarkovChain_FindWord(chain, keywords[i]);
+            if (keyword == kNoWord)
+                continue;
+
+            /* Search the states containing this keyword for a sentence starter */
+            for (posting = MarkovChain_FirstPosting(chain, chain->dictionary->wordNorm[keyword]);
+                 posting >= 0; posting = MarkovChain_NextPosting(chain, posting)) {
+                j = MarkovChain_PostingState(posting);
+                if (MarkovChain_StartsSentence(chain, j)) {
+                    /* Found a relevant starter state */
+                    return j;
+                }
+            }
+        }
+    }
+
+    /* If no match with predefined keywords, try to use the user's own words */
+    for (i = 0; i < prompt->count; i++) {
+        token = &prompt->tokens[i];
+        if (IsTopicWord(prompt, token) &&
+            (keyword = FindTokenKeyword(chain, prompt, token)) != kNoWord) {
+
+            /* Score only the states containing this word */
+            for (posting = MarkovChain_FirstPosting(chain, keyword);
+                 posting >= 0 && bestScore < kMaxRelevanceScore;
+                 posting = MarkovChain_NextPosting(chain, posting)) {
+                j              = MarkovChain_PostingState(posting);
+                relevanceScore = 1;
+
+                /* Prefer sentence starters with higher follower counts */
+                if (MarkovChain_StartsSentence(chain, j)) {
+                    relevanceScore += 2;
+                }
+                if (chain->nodes[j].followerCount > 2) {
+                    relevanceScore += 1;
+                }
+
+                if (relevanceScore > bestScore) {
+                    bestScore = relevanceScore;
+                    bestIndex = j;
+                }
+            }
+        }
+    }
+
+    return bestIndex;
+}
+
+/* Start strategy: a fresh sentence */
+static void StartSentence(MarkovGenerator *gen)
+{
+    BeginSentence(gen);
+}
+
+/* A random sentence starter containing a random prompt keyword, in any of the mixed chains, -1
+ * if there is none. Sets the chain it is in */
+static short RandomKeywordStarter(const MarkovGenerator *gen, MarkovChain **chosenChain)
+{
+    short posting, stateIndex, found = 0, chosen = -1, i;
+    MarkovChain *chain;
+    WordID keyword;
+
+    if (gen->keywordCount == 0)
+        return -1;
+
+    /* Reservoir sampling, so the postings are walked once */
+    keyword = gen->keywords[Random_Below(gen->random, gen->keywordCount)];
+    for (i = 0; i < gen->mixture.count; i++) {
+        chain = gen->mixture.chains[i];
+        for (posting = MarkovChain_FirstPosting(chain, keyword); posting >= 0;
+             posting = MarkovChain_NextPosting(chain, posting)) {
+            stateIndex = MarkovChain_PostingState(posting);
+            if (!MarkovChain_StartsSentence(chain, stateIndex))
+                continue;
+            if (Random_Below(gen->random, ++found) == 0) {
+                chosen       = stateIndex;
+                *chosenChain = chain;
+            }
+        }
+    }
+    return chosen;
+}
+
+/* Start strategy: a sentence starter related to the prompt's keywords. Later candidates start
+ * elsewhere among the keywords' contexts, so there is something to choose between */
+static void StartRelevant(MarkovGenerator *gen)
+{
+    MarkovChain *chain = NULL;
+    short stateIndex   = -1;
+    short i;
+
+    if (gen->candidate > 0)
+        stateIndex = RandomKeywordStarter(gen, &chain);
+    if (stateIndex < 0) {
+        if (gen->relevantState == kNotSearched) {
+            /* Chains are searched in mixture order, so the topic sub-models come first */
+            gen->relevantState = -1;
+            for (i = 0; i < gen->mixture.count && gen->relevantState < 0; i++) {
+                gen->relevantChain = gen->mixture.chains[i];
+                gen->relevantState = FindRelevantStartingState(gen->relevantChain, gen->prompt);
+            }
+        }
+        chain      = gen->relevantChain;
+        stateIndex = gen->relevantState;
+    }
+
+    if (stateIndex >= 0)
+        BeginWithState(gen, chain, stateIndex);
+    else
+        BeginSentence(gen);
+}
+
+/* Start strategy: carry on from the last words of the prompt without repeating them */
+static void StartContinuation(MarkovGenerator *gen)
+{
+    char text[kMaxTokenLength + 1];
+    const Token *token;
+    WordID word;
+    short i;
+
+    /* Only an unbroken run of known words at the end of the prompt is useful context. Words are
+     * looked up as written, less trailing punctuation */
+    gen->recentCount = 0;
+    for (i = 0; i < gen->prompt->count; i++) {
+        token = &gen->prompt->tokens[i];
+        Tokenizer_CopyWord(gen->prompt, token, token->keyLength, text, sizeof(text));
+
+        word = MarkovChain_FindWord(gen->words, text);
+        if (word == kNoWord) {
+            gen->recentCount = 0;
+            continue;
+        }
+        PushRecentWord(gen->recentWords, &gen->recentCount, word);
+    }
+
+    if (!MarkovMixture_HasContext(&gen->mixture, gen->recentWords, gen->recentCount))
+        StartRelevant(gen);
+}
+
+/* Sampling policy: weighted by trained frequency in the mixed chains, shaped by temperature and
+ * top-k */
+static WordID SampleWeighted(MarkovGenerator *gen)
+{
+    short logProb;
+    WordID word;
+
+    word = MarkovMixture_SampleFollower(&gen->mixture, gen->recentWords, gen->recentCount,
+                                        gen->random, &logProb);
+    if (word != kNoWord) {
+        gen->logProb += logProb;
+        gen->sampledWords++;
+    }
+    return word;
+}
+
+/* Sampling policy: the words of the most likely sentence a beam search finds among sampled
+ * followers, so candidates and replies differ; the next sentence is decoded whenever the last
+ * one has been used up */
+static WordID SampleBeam(MarkovGenerator *gen)
+{
+    if (gen->beamNext >= gen->beamCount) {
+        gen->beamCount = MarkovBeam_Decode(&gen->mixture, &gBeamPool, gen->recentWords,
+                                           gen->recentCount, gen->beamWidth,
+                                           MARKOV_BEAM_LENGTH_PENALTY, gen->random,
+                                           gen->beamWords, gen->beamLogProbs);
+        gen->beamNext  = 0;
+        if (gen->beamCount == 0)
+            return kNoWord;
+    }
+
+    gen->logProb += gen->beamLogProbs[gen->beamNext];
+    gen->sampledWords++;
+    return gen->beamWords[gen->beamNext++];
+}
+
+/* Stop criterion: enough sentences, too little room for another word, or out of time */
+static Boolean StopAtSentenceTarget(const MarkovGenerator *gen)
+{
+    return gen->text.sentenceCount >= gen->sentenceTarget ||
+           TextBuilder_Remaining(&gen->text) <= MAX_WORD_LENGTH || ReplyBudget_Expired();
+}
+
+/* End the current sentence and, unless that finishes the reply, begin another */
+static void BeginNextSentence(MarkovGenerator *gen)
+{
+    TextBuilder_EndSentence(&gen->text);
+    if (!gen->shouldStop(gen))
+        BeginSentence(gen);
+}
+
+/* Run the generation engine with a generator's strategies */
+static void RunGenerator(MarkovGenerator *gen, char *response, short maxLength)
+{
+    WordID nextWord;
+
+    TextBuilder_Init(&gen->text, response, maxLength);
+    gen->recentCount    = 0;
+    gen->wordCount      = 0;
+    gen->sentenceTarget = Random_Below(gen->random, 2) + 1; /* 1-2 sentences */
+    gen->keywordHits    = 0;
+    gen->logProb        = 0;
+    gen->sampledWords   = 0;
+    gen->repeatedWords  = 0;
+    gen->beamCount      = 0;
+    gen->beamNext       = 0;
+    memset(gen->seenWords, 0, sizeof(gen->seenWords));
+
+    gen->start(gen);
+
+    while (!gen->shouldStop(gen)) {
+        /* Follow the longest context of the recent words that has followers */
+        nextWord = gen->sample(gen);
+
+        if (nextWord == kNoWord || nextWord == kSentenceEnd) {
+            /* Sentence end, or a dead end: finish this sentence and start another */
+            BeginNextSentence(gen);
+            continue;
+        }
+
+        /* Add the next word; the builder notices when it ends a sentence */
+        EmitWord(gen, nextWord);
+
+        /* Avoid exceptionally long sentences */
+        if (gen->wordCount > 20 && gen->text.length - gen->text.sentenceStart > 15) {
+            BeginNextSentence(gen);
+        }
+    }
+
+    /* Ensure the response ends with proper punctuation */
+    TextBuilder_EndSentence(&gen->text);
+}
+
+/* Collect the distinct normalized topic words of the prompt that the chain knows */
+static void FindPromptKeywords(MarkovGenerator *gen)
+{
+    const TokenList *prompt = gen->prompt;
+    const Token *token;
+    WordID keyword;
+    short i, j;
+
+    gen->keywordCount = 0;
+    if (prompt == NULL)
+        return;
+
+    for (i = 0; i < prompt->count && gen->keywordCount < kMaxReplyKeywords; i++) {
+        token = &prompt->tokens[i];
+        if (IsTopicWord(prompt, token) &&
+            (keyword = FindTokenKeyword(gen->words, prompt, token)) != kNoWord) {
+            for (j = 0; j < gen->keywordCount && gen->keywords[j] != keyword; j++)
+                ;
+            if (j == gen->keywordCount)
+                gen->keywords[gen->keywordCount++] = keyword;
+        }
+    }
+}
+
+/* Score a finished candidate: prompt words used, plus how likely the chain finds it per word so
+ * longer replies aren't penalized for their length, less the share of words it repeats */
+static long ScoreCandidate(const MarkovGenerator *gen)
+{
+    long score = 0;
+    short i;
+
+    for (i = 0; i < gen->keywordCount; i++) {
+        if (gen->keywordHits & (1 << i))
+            score += kKeywordBonus;
+    }
+    if (gen->sampledWords > 0)
+        score += gen->logProb / gen->sampledWords;
+    if (gen->wordCount > 0)
+        score -= (long)kRepeatPenalty * gen->repeatedWords / gen->wordCount;
+    return score;
+}
+
+/* Reply to a prompt with the best of up to candidates replies from a mixture of chains */
+char *MarkovReply_Generate(const MarkovMixture *mixture, const TokenList *prompt, short candidates,
+                           short beamWidth, RandomStream *random)
+{
+    static char replies[2][kMarkovReplyLength]; /* The best candidate so far and the next one */
+    short best = 0, candidate = 1;
+    long score, bestScore = 0;
+    unsigned long candidatesStart;
+    MarkovGenerator gen;
+    size_t len;
+    short i;
+
+    gen.start         = StartSentence;
+    gen.sample        = (beamWidth > 1) ? SampleBeam : SampleWeighted;
+    gen.shouldStop    = StopAtSentenceTarget;
+    gen.prompt        = (prompt != NULL && prompt->count > 0) ? prompt : NULL;
+    gen.mixture       = *mixture;
+    gen.words         = mixture->chains[0];
+    gen.random        = random;
+    gen.beamWidth     = beamWidth;
+    gen.relevantState = kNotSearched;
+    gen.relevantChain = NULL;
+
+    /* Reply to the user's keywords, or finish their sentence if it trails off */
+    if (gen.prompt != NULL) {
+        len       = strlen(prompt->text);
+        gen.start = (len >= 3 && strcmp(prompt->text + len - 3, "...") == 0) ? StartContinuation
+                                                                            : StartRelevant;
+    }
+
+    FindPromptKeywords(&gen);
+
+    /* Generate candidates until the count or the reply budget runs out, keeping the best. Stop
+     * early when one more candidate, at the average cost so far, would overrun the budget. A
+     * candidate cut short by the budget still competes with the finished ones */
+    candidatesStart = ReplyBudget_Elapsed();
+    for (i = 0; i < candidates; i++) {
+        if (i > 0 && (ReplyBudget_Elapsed() - candidatesStart) / i >= ReplyBudget_Remaining())
+            break;
+
+        gen.candidate = i;
+        RunGenerator(&gen, replies[candidate], kMarkovReplyLength);
+        score = ScoreCandidate(&gen);
+        if (i == 0 || score > bestScore) {
+            bestScore = score;
+            best      = candidate;
+            candidate = 1 - candidate;
+        }
+    }
+    return replies[best];
+}
@@ -0,0 +1,23 @@
+#ifndef MARKOV_REPLY_H
+#define MARKOV_REPLY_H
+
+#include "markov_mixture.h"
+#include "random.h"
+#include "tokenizer.h"
+
+/* Reply generation over a mixture of chains: best-of-N candidates of 1-2 sentences each,
+ * sampled word by word or beam decoded, scored by the prompt words they use and how likely the
+ * chains find them. The app and the benchmark both reply through here */
+#define kMarkovReplyLength 500 /* Longest reply, in characters */
+#define kMaxCandidates 8       /* Most candidates a reply is picked from */
+
+/* Reply to a prompt, or to nothing if prompt is NULL, from a mixture of chains sharing one
+ * dictionary. Generates up to candidates replies and returns the best, drawing from random;
+ * a beam width above 1 decodes each sentence as the most likely of that many partial ones
+ * instead of sampling it. Stops early once the reply budget, which the caller starts, runs
+ * out. Returns an empty string if it ran out before the first word. The reply stays valid
+ * until the next call */
+char *MarkovReply_Generate(const MarkovMixture *mixture, const TokenList *prompt, short candidates,
+                           short beamWidth, RandomStream *random);
+
+#endif /* MARKOV_REPLY_H */
@@ -0,0 +1,149 @@
+#include <stddef.h>
+#include <string.h>
+
+#include "markov_topic.h"
+
+#define kMaxTopicWordLength 16 /* Longer words are no keyword, so they are skipped */
+#define kMaxTopicKeywords 48   /* Keywords in any one topic's list */
+
+/* Keywords for each topic, lowercase; a trailing s on the prompt word is allowed too */
+static const char *const kMacKeywords[] = {
+    "mac",        "macintosh",  "apple",      "computer",   "computing",  "system",
+    "finder",     "software",   "hardware",   "program",    "code",       "coding",
+    "disk",       "floppy",     "file",       "folder",     "ram",        "chip",
+    "processor",  "cpu",        "powerbook",  "classic",    "vintage",    "tech",
+    "ai",         "app",        "desktop",    "mouse",      "keyboard",   "screen",
+    "monitor",    "hypercard",  "printer",    "network",    "internet",   "digital",
+    "crash",      "bug",        "font",       "icon",       "window",     "technology",
+    NULL};
+
+static const char *const kScienceKeywords[] = {
+    "science",    "scientist",  "scientific", "physics",    "chemistry",  "biology",
+    "space",      "star",       "planet",     "universe",   "atom",       "energy",
+    "gravity",    "light",      "nature",     "animal",     "species",    "plant",
+    "tree",       "forest",     "ocean",      "earth",      "dna",        "gene",
+    "evolution",  "brain",      "memory",     "memories",   "mind",       "psychology",
+    "learn",      "learning",   "study",      "studying",   "school",     "teach",
+    "education",  "history",    "math",       "experiment", "research",   "fact",
+    "trivia",     "weather",    NULL};
+
+static const char *const kHealthKeywords[] = {
+    "health",       "healthy",      "exercise",     "sleep",        "diet",         "stress",
+    "wellness",     "doctor",       "food",         "cook",         "cooking",      "recipe",
+    "cuisine",      "eat",          "meal",         "kitchen",      "work",         "job",
+    "habit",        "routine",      "goal",         "task",         "focus",        "productivity",
+    "money",        "budget",       "saving",       "invest",       "investing",    "finance",
+    "financial",    "credit",       "home",         "house",        "garden",       "clean",
+    NULL};
+
+static const char *const kLeisureKeywords[] = {
+    "art",         "artist",      "music",       "song",        "paint",       "painting",
+    "draw",        "drawing",     "photo",       "photography", "write",       "writing",
+    "poetry",      "poem",        "book",        "story",       "creative",    "hobby",
+    "craft",       "dance",       "film",        "movie",       "theater",     "museum",
+    "travel",      "trip",        "vacation",    "city",        "country",     "culture",
+    "beach",       "landscape",   "sport",       "team",        "athlete",     "olympics",
+    "ball",        "game",        "play",        NULL};
+
+/* Keyword lists in MarkovTopic order; the general topic has none */
+static const char *const *const kTopicKeywords[kMarkovTopicCount] = {
+    NULL, kMacKeywords, kScienceKeywords, kHealthKeywords, kLeisureKeywords};
+
+static const char *const kTopicNames[kMarkovTopicCount] = {"General", "Mac", "Science", "Health",
+                                                           "Leisure"};
+
+/* Hashes of the keywords, so most can be ruled out without comparing them; made on first use */
+static unsigned short gKeywordHashes[kMarkovTopicCount][kMaxTopicKeywords];
+static Boolean gKeywordsHashed = FALSE;
+
+/* Name of a topic */
+const char *MarkovTopic_Name(MarkovTopic topic)
+{
+    return (topic >= 0 && topic < kMarkovTopicCount) ? kTopicNames[topic] : "Unknown";
+}
+
+/* Hash every topic's keywords */
+static void HashKeywords(void)
+{
+    const char *const *keywords;
+    short topic, i;
+
+    for (topic = kMarkovTopicGeneral + 1; topic < kMarkovTopicCount; topic++) {
+        keywords = kTopicKeywords[topic];
+        for (i = 0; keywords[i] != NULL; i++) {
+            gKeywordHashes[topic][i] = Tokenizer_Hash(keywords[i], strlen(keywords[i]));
+        }
+    }
+    gKeywordsHashed = TRUE;
+}
+
+/* Check whether a lowercase word with the given hash is one of a topic's keywords, or one of
+ * them plus an s, whose hash without the s is pluralHash */
+static Boolean IsKeyword(MarkovTopic topic, const char *word, short length, unsigned short hash,
+                         unsigned short pluralHash)
+{
+    const char *const *keywords  = kTopicKeywords[topic];
+    const unsigned short *hashes = gKeywordHashes[topic];
+    Boolean plural               = length > 1 && word[length - 1] == 's';
+    short i;
+
+    for (i = 0; keywords[i] != NULL; i++) {
+        if ((hashes[i] == hash && strcmp(keywords[i], word) == 0) ||
+            (plural && hashes[i] == pluralHash && strncmp(keywords[i], word, length - 1) == 0 &&
+             keywords[i][length - 1] == '\0'))
+            return TRUE;
+    }
+    return FALSE;
+}
+
+/* Pick the topics a prompt is about by the keywords it contains */
+short MarkovTopic_Route(const TokenList *tokens, MarkovTopic *topics, short *hits, short max)
+{
+    short counts[kMarkovTopicCount];
+    MarkovTopic ranked[kMarkovTopicCount];
+    char word[kMaxTopicWordLength + 1];
+    unsigned short pluralHash;
+    const Token *token;
+    short length, topic, found, i;
+
+    memset(counts, 0, sizeof(counts));
+    if (tokens == NULL)
+        return 0;
+    if (!gKeywordsHashed)
+        HashKeywords();
+
+    /* Words are compared by their keys, in lowercase without trailing punctuation */
+    for (i = 0; i < tokens->count; i++) {
+        token = &tokens->tokens[i];
+        if (token->keyLength > kMaxTopicWordLength)
+            continue;
+
+        length     = Tokenizer_CopyKey(tokens, token, word, sizeof(word));
+        pluralHash = Tokenizer_Hash(word, length - 1);
+        for (topic = kMarkovTopicGeneral + 1; topic < kMarkovTopicCount; topic++) {
+            if (IsKeyword((MarkovTopic)topic, word, length, token->hash, pluralHash))
+                counts[topic]++;
+        }
+    }
+
+    /* Most keywords first; ties keep topic order */
+    found = 0;
+    for (topic = kMarkovTopicGeneral + 1; topic < kMarkovTopicCount; topic++) {
+        if (counts[topic] == 0)
+            continue;
+        for (i = found; i > 0 && counts[ranked[i - 1]] < counts[topic]; i--) {
+            ranked[i] = ranked[i - 1];
+        }
+        ranked[i] = (MarkovTopic)topic;
+        found++;
+    }
+
+    if (found > max)
+        found = max;
+    for (i = 0; i < found; i++) {
+        topics[i] = ranked[i];
+        if (hits != NULL)
+            hits[i] = counts[ranked[i]];
+    }
+    return found;
+}
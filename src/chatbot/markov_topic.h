@@ -0,0 +1,26 @@
+#ifndef MARKOV_TOPIC_H
+#define MARKOV_TOPIC_H
+
+#include "portable.h"
+#include "tokenizer.h"
+
+/* Topics the static corpus is split into. Each has its own sub-model sharing the general
+ * model's dictionary; the general model is trained on everything, so it knows every topic */
+typedef enum {
+    kMarkovTopicGeneral, /* Conversation; the general model, never routed to */
+    kMarkovTopicMac,
+    kMarkovTopicScience,
+    kMarkovTopicHealth,
+    kMarkovTopicLeisure, /* Travel, sports and the arts */
+    kMarkovTopicCount
+} MarkovTopic;
+
+/* Name of a topic, for tools and debugging */
+const char *MarkovTopic_Name(MarkovTopic topic);
+
+/* Pick the topics a prompt is about by the keywords among its tokens, most keywords first and
+ * ties in topic order. Fills up to max topics and their keyword counts (hits may be NULL) and
+ * returns how many; 0 if the prompt names no topic. The general topic is never picked */
+short MarkovTopic_Route(const TokenList *tokens, MarkovTopic *topics, short *hits, short max);
+
+#endif /* MARKOV_TOPIC_H */
@@ -1,11 +1,16 @@
+#include <Events.h>
 #include <Memory.h>
+#include <OSUtils.h>
 #include <stdio.h>
+#include <stdlib.h>
 #include <string.h>
 
 #include "../constants.h"
 #include "markov.h"
 #include "model_manager.h"
 #include "openai.h"
+#include "random.h"
+#include "reply_budget.h"
 #include "template.h"
 
 /* Global conversation history */
@@ -17,6 +22,85 @@ AIModelType gActiveAIModel = kMarkovModel;
 /* Track initialization status */
 Boolean gModelsInitialized = false;
 
+/* The last user message, split once for the models to share */
+static TokenList gPromptTokens;
+
+#ifdef DEBUG
+/* Debug commands, typed instead of a prompt to the Markov model. /stats asks for its statistics;
+ * the others change how it replies for the rest of the session and answer with the result */
+#define kStatsCommand "/stats"
+#define kSamplingCommand "/sampling"     /* Temperature in percent, then top-k */
+#define kCandidatesCommand "/candidates" /* Replies generated to pick the best of */
+#define kBeamCommand "/beam"             /* Beam width, 1 to sample */
+#define kBudgetCommand "/budget"         /* Time a reply may take, in milliseconds */
+#define kMaxStatsLength 640
+
+static const char *const kDebugCommands[] = {kStatsCommand, kSamplingCommand, kCandidatesCommand,
+                                             kBeamCommand,  kBudgetCommand,   NULL};
+
+/* Check whether a prompt is one of the debug commands */
+static Boolean IsDebugCommand(const TokenList *tokens)
+{
+    return tokens != NULL && tokens->count > 0 &&
+           Tokenizer_KeyIn(tokens, &tokens->tokens[0], kDebugCommands);
+}
+
+/* Check whether a prompt is the given debug command with the given number of arguments */
+static Boolean IsCommand(const TokenList *tokens, const char *command, short arguments)
+{
+    return tokens->count == arguments + 1 &&
+           Tokenizer_KeyIs(tokens, &tokens->tokens[0], command);
+}
+
+/* Get a debug command's numeric argument, 1 for the first */
+static short CommandArgument(const TokenList *tokens, short argument)
+{
+    return (short)atoi(Tokenizer_Word(tokens, &tokens->tokens[argument]));
+}
+
+/* Describe how replies kept to their time budget, in milliseconds, after the Markov chain's
+ * statistics if there are any */
+static char *DescribeReplies(const char *markovStats)
+{
+    static char description[kMaxStatsLength];
+    ReplyBudgetStats stats;
+
+    ReplyBudget_GetStats(&stats);
+    sprintf(description,
+            "%s%sReplies: %lu, %lu over the %lu ms budget; last %lu ms, mean %lu, slowest %lu%s.",
+            markovStats, (markovStats[0] != '\0') ? " " : "", stats.replies, stats.overruns,
+            stats.budget / 1000, stats.last / 1000,
+            (stats.replies > 0) ? stats.total / stats.replies : 0, stats.longest / 1000,
+            stats.microseconds ? "" : ", timed in ticks");
+    return description;
+}
+
+/* Run a debug command and return its answer */
+static char *RunDebugCommand(const TokenList *tokens)
+{
+    if (IsCommand(tokens, kStatsCommand, 0))
+        return DescribeReplies(DescribeMarkovStats());
+    if (IsCommand(tokens, kSamplingCommand, 2)) {
+        SetMarkovSampling(CommandArgument(tokens, 1), CommandArgument(tokens, 2));
+        return DescribeMarkovSettings();
+    }
+    if (IsCommand(tokens, kCandidatesCommand, 1)) {
+        SetMarkovCandidates(CommandArgument(tokens, 1));
+        return DescribeMarkovSettings();
+    }
+    if (IsCommand(tokens, kBeamCommand, 1)) {
+        SetMarkovBeamWidth(CommandArgument(tokens, 1));
+        return DescribeMarkovSettings();
+    }
+    if (IsCommand(tokens, kBudgetCommand, 1)) {
+        SetReplyBudget(CommandArgument(tokens, 1));
+        return DescribeReplies("");
+    }
+    return "Commands: /stats, /sampling temperature top-k, /candidates count, /beam width, "
+           "/budget milliseconds.";
+}
+#endif
+
 /* Initialize all AI models and conversation history */
 void InitModels(void)
 {
@@ -27,9 +111,17 @@ void InitModels(void)
     gConversationHistory.head   = 0;
     gConversationHistory.isFull = 0;
     memset(gConversationHistory.messages, 0, sizeof(ConversationMessage) * kMaxConversationHistory);
+    gPromptTokens.text = NULL;
 
     /* Initialize the selected model if not already initialized */
     if (!gModelsInitialized) {
+#ifndef DETERMINISTIC
+        /* Different replies every launch, unless built to repeat runs exactly */
+        unsigned long now;
+
+        GetDateTime(&now);
+        Random_SetSessionSeed(now ^ TickCount());
+#endif
         if (gActiveAIModel == kMarkovModel) {
             InitMarkovModel();
         }
@@ -62,6 +154,9 @@ void SetActiveAIModel(AIModelType modelType)
 {
     /* Only change model and initialize if it's a different model */
     if (gActiveAIModel != modelType) {
+        /* The Markov chain is the one model with a large heap block; free it for the others */
+        if (gActiveAIModel == kMarkovModel)
+            ReleaseMarkovModel();
         gActiveAIModel = modelType;
 
         /* Initialize the newly selected model */
@@ -77,21 +172,76 @@ void SetActiveAIModel(AIModelType modelType)
     }
 }
 
-/* Generate AI response based on active model */
+/* Give the active model time for background work */
+void IdleModels(void)
+{
+    if (gActiveAIModel == kMarkovModel)
+        TrainMarkovIdle();
+}
+
+/* Save what the models learned during this session, before quitting */
+void SaveModels(void)
+{
+    /* Only the Markov chain learns; it saves nothing unless it changed */
+    SaveMarkovChain();
+}
+
+/* Find the last user message in a history, NULL if there is none */
+static const char *LastUserMessage(const ConversationHistory *history)
+{
+    short i, index;
+
+    if (history == NULL)
+        return NULL;
+
+    for (i = history->count - 1; i >= 0; i--) {
+        index = (history->head + i) % kMaxConversationHistory;
+        if (history->messages[index].type == kUserMessage)
+            return history->messages[index].text;
+    }
+    return NULL;
+}
+
+/* Get the last user message in a history split into tokens, NULL if there is none. It is
+ * usually the prompt just added, which is already split */
+static const TokenList *PromptTokens(const ConversationHistory *history)
+{
+    const char *message = LastUserMessage(history);
+
+    if (message == NULL)
+        return NULL;
+    if (gPromptTokens.text != message)
+        Tokenizer_Split(&gPromptTokens, message);
+    return &gPromptTokens;
+}
+
+/* Generate AI response based on active model, within the reply time budget */
 char *GenerateAIResponse(const ConversationHistory *history)
 {
+    char *response;
+
+#ifdef DEBUG
+    if (gActiveAIModel == kMarkovModel && IsDebugCommand(PromptTokens(history)))
+        return RunDebugCommand(PromptTokens(history));
+#endif
+
+    ReplyBudget_Start();
     if (gActiveAIModel == kMarkovModel) {
-        return GenerateMarkovResponse(history);
+        response = GenerateMarkovResponse(PromptTokens(history));
     }
-    if (gActiveAIModel == kOpenAIModel) {
-        return GenerateOpenAIResponse(history);
+    else if (gActiveAIModel == kOpenAIModel) {
+        response = GenerateOpenAIResponse(history);
     }
-    if (gActiveAIModel == kTemplateModel) {
-        return GenerateTemplateResponse(history);
+    else if (gActiveAIModel == kTemplateModel) {
+        response = GenerateTemplateResponse(PromptTokens(history));
     }
+    else {
+        /* Default case to avoid missing return */
+        response = "Error: Unknown model type";
+    }
+    ReplyBudget_Finish();
 
-    /* Default case to avoid missing return */
-    return "Error: Unknown model type";
+    return response;
 }
 
 /* Calculate the tail index (position for the new item) in the circular buffer */
@@ -111,8 +261,8 @@ static short CircularBufferTail(void)
     }
 }
 
-/* Add an item to the circular buffer and update head/count/isFull */
-static void AddToCircularBuffer(MessageType type, const char *text)
+/* Add an item to the circular buffer and update head/count/isFull, returns the stored text */
+static const char *AddToCircularBuffer(MessageType type, const char *text)
 {
     short tail = CircularBufferTail();
 
@@ -133,12 +283,22 @@ static void AddToCircularBuffer(MessageType type, const char *text)
             gConversationHistory.isFull = 1;
         }
     }
+    return gConversationHistory.messages[tail].text;
 }
 
 /* Add a user prompt to the conversation */
 void AddUserPrompt(const char *prompt)
 {
-    AddToCircularBuffer(kUserMessage, prompt);
+    /* Split the stored copy, which stays put until the reply is made */
+    Tokenizer_Split(&gPromptTokens, AddToCircularBuffer(kUserMessage, prompt));
+
+#ifdef DEBUG
+    /* Debug commands are nothing to learn from */
+    if (IsDebugCommand(&gPromptTokens))
+        return;
+#endif
+    if (gActiveAIModel == kMarkovModel)
+        LearnMarkovPrompt(&gPromptTokens);
 }
 
 /* Add an AI response to the conversation */
@@ -18,9 +18,15 @@ void InitModels(void);
 /* Set the active AI model */
 void SetActiveAIModel(AIModelType modelType);
 
+/* Give the active model time for background work, such as training */
+void IdleModels(void);
+
 /* Generate AI response based on active model */
 char *GenerateAIResponse(const ConversationHistory *history);
 
+/* Save what the models learned during this session, before quitting */
+void SaveModels(void);
+
 /* Add a user prompt to the conversation */
 void AddUserPrompt(const char *prompt);
 
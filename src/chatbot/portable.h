@@ -0,0 +1,16 @@
+#ifndef PORTABLE_H
+#define PORTABLE_H
+
+/* Modules without Toolbox dependencies include this instead of <Types.h>, so host tools can
+ * build them too */
+#ifdef MARKOV_HOST_BUILD
+typedef unsigned char Boolean;
+#ifndef TRUE
+#define TRUE 1
+#define FALSE 0
+#endif
+#else
+#include <Types.h>
+#endif
+
+#endif /* PORTABLE_H */
@@ -0,0 +1,71 @@
+#include "random.h"
+
+#define kRandomMask 0xFFFFFFFFUL    /* unsigned long is wider than 32 bits on some hosts */
+#define kStreamSpacing 0x9E3779B9UL /* 2^32 / golden ratio, spreads stream IDs apart */
+
+/* Seed the engines' streams start from */
+static unsigned long gSessionSeed = kRandomFixedSeed;
+
+/* Set the seed engines draw their streams from */
+void Random_SetSessionSeed(unsigned long seed)
+{
+    gSessionSeed = seed & kRandomMask;
+}
+
+/* Get the session seed */
+unsigned long Random_SessionSeed(void)
+{
+    return gSessionSeed;
+}
+
+/* Scramble every bit of a seed into every other, so seeds one apart start far apart */
+static unsigned long MixSeed(unsigned long x)
+{
+    x ^= x >> 16;
+    x = (x * 0x7FEB352DUL) & kRandomMask;
+    x ^= x >> 15;
+    x = (x * 0x846CA68BUL) & kRandomMask;
+    x ^= x >> 16;
+    return x;
+}
+
+/* Start a stream from a seed */
+void Random_Seed(RandomStream *stream, unsigned long seed, RandomStreamID id)
+{
+    stream->state = MixSeed((seed + id * kStreamSpacing) & kRandomMask);
+    if (stream->state == 0)
+        stream->state = kStreamSpacing; /* xorshift never leaves zero */
+}
+
+/* Draw 32 random bits */
+unsigned long Random_Next(RandomStream *stream)
+{
+    unsigned long x = stream->state;
+
+    x ^= (x << 13) & kRandomMask;
+    x ^= x >> 17;
+    x ^= (x << 5) & kRandomMask;
+    stream->state = x;
+    return x;
+}
+
+/* Draw a number from 0 to bound - 1. Scaling 16 random bits by bound maps each of the 65536
+ * draws into one of bound buckets in the high half; the low half says where in its bucket the
+ * draw fell. The first 65536 % bound low halves are the ones that make some buckets bigger, so
+ * those are drawn again. Computing that remainder is only needed for low halves below bound */
+unsigned short Random_Below(RandomStream *stream, unsigned short bound)
+{
+    unsigned long product;
+    unsigned short threshold;
+
+    if (bound == 0)
+        return 0;
+
+    product = (Random_Next(stream) >> 16) * (unsigned long)bound;
+    if ((unsigned short)product < bound) {
+        threshold = (unsigned short)((0x10000UL - bound) % bound);
+        while ((unsigned short)product < threshold)
+            product = (Random_Next(stream) >> 16) * (unsigned long)bound;
+    }
+    return (unsigned short)(product >> 16);
+}
@@ -0,0 +1,41 @@
+#ifndef RANDOM_H
+#define RANDOM_H
+
+#include "portable.h"
+
+/* Random numbers shared by the chatbot engines: xorshift32, which needs only shifts and
+ * exclusive ors on a 68000. Each engine draws from its own stream, so one engine's draws never
+ * shift another's, and every stream is seeded explicitly, so a run can be repeated exactly */
+typedef struct {
+    unsigned long state; /* Never zero once seeded; zero means not seeded yet */
+} RandomStream;
+
+/* One stream per engine, so engines given the same seed still draw different numbers */
+typedef enum {
+    kRandomStreamChain    = 1, /* Follower replacement while training, in the chain itself */
+    kRandomStreamMarkov   = 2, /* Markov reply generation */
+    kRandomStreamTemplate = 3, /* Template selection */
+    kRandomStreamBench    = 4  /* Host benchmarks */
+} RandomStreamID;
+
+/* Seed of the chain's own stream and of deterministic runs */
+#define kRandomFixedSeed 1
+
+/* Set the seed engines draw their streams from. The app sets it from the clock at startup,
+ * unless built with DETERMINISTIC, which keeps kRandomFixedSeed so runs repeat bit for bit */
+void Random_SetSessionSeed(unsigned long seed);
+
+/* Get the session seed, kRandomFixedSeed unless it was set */
+unsigned long Random_SessionSeed(void);
+
+/* Start a stream from a seed. Nearby seeds and stream IDs start far apart */
+void Random_Seed(RandomStream *stream, unsigned long seed, RandomStreamID id);
+
+/* Draw 32 random bits */
+unsigned long Random_Next(RandomStream *stream);
+
+/* Draw a number from 0 to bound - 1, each equally likely. Takes one 16 by 16 bit multiply and
+ * rarely a second draw, rather than a division; returns 0 if bound is 0 */
+unsigned short Random_Below(RandomStream *stream, unsigned short bound);
+
+#endif /* RANDOM_H */
@@ -0,0 +1,121 @@
+#ifdef MARKOV_HOST_BUILD
+#include <time.h>
+#else
+#include <Events.h>
+#include <Gestalt.h>
+#include <Timer.h>
+#endif
+
+#include "reply_budget.h"
+
+/* Time a reply may take before engines settle for what they have */
+#ifndef REPLY_BUDGET_MS
+#define REPLY_BUDGET_MS 750
+#endif
+#define kMicrosecondsPerTick 16667 /* Ticks come 60.15 times a second; close enough */
+
+/* Budget in microseconds, and when the current reply started in the clock's own units */
+static unsigned long gBudget = REPLY_BUDGET_MS * 1000L;
+static unsigned long gStart;
+
+/* Whether the Microseconds trap is there, checked on the first reply */
+static Boolean gClockChecked = FALSE;
+static Boolean gUseMicroseconds;
+
+/* Totals for tuning the budget */
+static unsigned long gReplies;
+static unsigned long gOverruns;
+static unsigned long gLongest;
+static unsigned long gLast;
+static unsigned long gTotal; /* Milliseconds, so it lasts weeks of replies */
+
+/* Read the clock: the low half of Microseconds, or TickCount on machines without the extended
+ * Time Manager. Differences stay right across wraparound, which is over an hour away. Host
+ * tools time with the processor clock in microseconds */
+static unsigned long ReadClock(void)
+{
+#ifdef MARKOV_HOST_BUILD
+    return (unsigned long)((double)clock() * 1000000.0 / CLOCKS_PER_SEC);
+#else
+    UnsignedWide now;
+
+    if (!gUseMicroseconds)
+        return TickCount();
+
+    Microseconds(&now);
+    return now.lo;
+#endif
+}
+
+/* Set the time a reply may take, in milliseconds */
+void SetReplyBudget(long milliseconds)
+{
+    if (milliseconds < 1)
+        milliseconds = 1;
+    gBudget = milliseconds * 1000;
+}
+
+/* Start timing a reply */
+void ReplyBudget_Start(void)
+{
+    if (!gClockChecked) {
+#ifdef MARKOV_HOST_BUILD
+        gUseMicroseconds = TRUE;
+#else
+        long version;
+
+        gUseMicroseconds = Gestalt(gestaltTimeMgrVersion, &version) == noErr &&
+                           version >= gestaltExtendedTimeMgr;
+#endif
+        gClockChecked = TRUE;
+    }
+    gStart = ReadClock();
+}
+
+/* Microseconds since the reply started */
+unsigned long ReplyBudget_Elapsed(void)
+{
+    unsigned long elapsed = ReadClock() - gStart;
+
+    return gUseMicroseconds ? elapsed : elapsed * kMicrosecondsPerTick;
+}
+
+/* Microseconds the reply has left, 0 once the budget has run out */
+unsigned long ReplyBudget_Remaining(void)
+{
+    unsigned long elapsed = ReplyBudget_Elapsed();
+
+    return (elapsed < gBudget) ? gBudget - elapsed : 0;
+}
+
+/* Check whether the reply has used up its budget */
+Boolean ReplyBudget_Expired(void)
+{
+    return ReplyBudget_Elapsed() >= gBudget;
+}
+
+/* Stop timing a reply, counting it as an overrun if it took longer than the budget */
+void ReplyBudget_Finish(void)
+{
+    unsigned long elapsed = ReplyBudget_Elapsed();
+
+    gReplies++;
+    if (elapsed > gBudget)
+        gOverruns++;
+    if (elapsed > gLongest)
+        gLongest = elapsed;
+    gLast = elapsed;
+    gTotal += elapsed / 1000;
+}
+
+/* Get the reply timing statistics */
+void ReplyBudget_GetStats(ReplyBudgetStats *stats)
+{
+    stats->replies      = gReplies;
+    stats->overruns     = gOverruns;
+    stats->longest      = gLongest;
+    stats->last         = gLast;
+    stats->total        = gTotal;
+    stats->budget       = gBudget;
+    stats->microseconds = gUseMicroseconds;
+}
@@ -0,0 +1,40 @@
+#ifndef REPLY_BUDGET_H
+#define REPLY_BUDGET_H
+
+#include "portable.h"
+
+/* Time limit for generating one reply, so no engine can stall the event loop for long. The
+ * model manager starts the clock before asking an engine for a reply; engines check it as they
+ * go and, once it has run out, return the best reply they have so far */
+typedef struct {
+    unsigned long replies;  /* Replies timed */
+    unsigned long overruns; /* Replies that took longer than the budget */
+    unsigned long longest;  /* Slowest reply, in microseconds */
+    unsigned long last;     /* The last reply, in microseconds */
+    unsigned long total;    /* All replies together, in milliseconds */
+    unsigned long budget;   /* Current budget, in microseconds */
+    Boolean microseconds;   /* Timed in microseconds; otherwise with ticks, 1/60 second */
+} ReplyBudgetStats;
+
+/* Set the time a reply may take, in milliseconds */
+void SetReplyBudget(long milliseconds);
+
+/* Start timing a reply */
+void ReplyBudget_Start(void);
+
+/* Microseconds since the reply started */
+unsigned long ReplyBudget_Elapsed(void);
+
+/* Microseconds the reply has left, 0 once the budget has run out */
+unsigned long ReplyBudget_Remaining(void);
+
+/* Check whether the reply has used up its budget */
+Boolean ReplyBudget_Expired(void);
+
+/* Stop timing a reply, counting it as an overrun if it took longer than the budget */
+void ReplyBudget_Finish(void);
+
+/* Get the reply timing statistics, for tuning the budget to the machine */
+void ReplyBudget_GetStats(ReplyBudgetStats *stats);
+
+#endif /* REPLY_BUDGET_H */
@@ -11,33 +11,42 @@
 
 #include "../constants.h"
 #include "../ui/utils.h"
+#include "random.h"
+#include "reply_budget.h"
 #include "template.h"
 #include "template_data.h"
+#include "text_builder.h"
 
-/* Global template database */
-static ResponseTemplate gTemplates[MAX_TEMPLATES];
-static short gTemplateCount = 0;
+/* Templates scored between checks of the reply budget */
+#define kTemplatesPerBudgetCheck 16
 
-/* Global random seed */
-static unsigned long gRandomSeed = 1;
+/* Words too common to say anything about the topic, besides those under 3 letters */
+static const char *const kStopWords[] = {
+    /* Articles, prepositions, conjunctions */
+    "the", "and", "for", "that", "with", "but", "yet", "nor", "because", "from", "this", "these",
+    "those", "there", "then", "than", "into", "onto", "upon", "over", "under", "above", "below",
+    "near",
 
-/* Custom random number generator - named differently to avoid conflicts */
-static unsigned long TemplateRandomGen(void)
-{
-    gRandomSeed = gRandomSeed * 1103515245 + 12345;
-    return (gRandomSeed >> 16) & 0x7FFF;
-}
+    /* Question words */
+    "what", "why", "how", "when", "where", "which", "who", "whose", "whom", "tell", "about",
+    "explain", "describe", "show", "discuss", "define",
 
-/* Initialize the random seed */
-static void InitRandom(void)
-{
-    /* Use the system time to seed the random number generator */
-    DateTimeRec dateTime;
-    GetTime(&dateTime);
+    /* Common verbs */
+    "are", "will", "does", "did", "can", "could", "would", "should", "may", "might", "have", "has",
+    "had", "was", "were", "been", "being", "you", "not", "think", "know", "get", "see", "look",
+    "make", "want", "come", "take", "use", "find", "give", "some",
 
-    /* Seed our custom random function with current time */
-    gRandomSeed = (dateTime.hour * 3600) + (dateTime.minute * 60) + dateTime.second + dateTime.year;
-}
+    /* Possessives and personal pronouns */
+    "your", "yours", "our", "ours", "their", "theirs", "his", "her", "hers", "its", "mine", "they",
+    "them", "she", "him", "one", "any", "all", "each", "both", "few", "many", "more", "most",
+    "other", "such", "just", "very", NULL};
+
+/* Global template database */
+static ResponseTemplate gTemplates[MAX_TEMPLATES];
+static short gTemplateCount = 0;
+
+/* Random numbers for picking templates, from the session seed */
+static RandomStream gRandom;
 
 /* Add a template with its patterns */
 void AddTemplate(const char *response, unsigned char category, const char **patterns,
@@ -59,6 +68,7 @@ void AddTemplate(const char *response, unsigned char category, const char **patt
     for (i = 0; i < patternCount && i < MAX_PATTERNS; i++) {
         strncpy(gTemplates[gTemplateCount].patterns[i], patterns[i], MAX_PATTERN_LENGTH - 1);
         gTemplates[gTemplateCount].patterns[i][MAX_PATTERN_LENGTH - 1] = '\0';
+        ConvertToLowercase(gTemplates[gTemplateCount].patterns[i]); /* Matched in lowercase */
         gTemplates[gTemplateCount].patternCount++;
     }
 
@@ -187,135 +197,71 @@ void AddDynamicSystemTemplates(void)
     AddTemplate(buffer, kCategoryMac, patterns, 3);
 }
 
-/* Check if a pattern exists in the text (case insensitive) */
-static Boolean PatternMatches(const char *pattern, const char *text)
+/* Check whether a lowercase word is too common to be a keyword */
+static Boolean IsStopWord(const char *word)
 {
-    char patternLower[MAX_PATTERN_LENGTH];
-    char textLower[kMaxPromptLength];
-
-    /* Make lowercase copies for case-insensitive matching */
-    strncpy(patternLower, pattern, MAX_PATTERN_LENGTH - 1);
-    patternLower[MAX_PATTERN_LENGTH - 1] = '\0';
-    ConvertToLowercase(patternLower);
-
-    strncpy(textLower, text, kMaxPromptLength - 1);
-    textLower[kMaxPromptLength - 1] = '\0';
-    ConvertToLowercase(textLower);
+    short i;
 
-    /* Check if pattern exists in text */
-    return (strstr(textLower, patternLower) != NULL);
+    for (i = 0; kStopWords[i] != NULL; i++) {
+        if (strcmp(kStopWords[i], word) == 0)
+            return TRUE;
+    }
+    return FALSE;
 }
 
 /* Extract keywords from user input for more contextual responses */
-static void ExtractKeywords(const char *input, ExtractedKeyword *keywords, short *keywordCount)
+static void ExtractKeywords(const TokenList *prompt, ExtractedKeyword *keywords,
+                            short *keywordCount)
 {
-    char buffer[kMaxPromptLength];
-    char *token;
+    const Token *token;
+    const char *word;
+    char *keyword;
     short count = 0;
+    short start, end, length, i, j;
+
+    for (i = 0; i < prompt->count && count < MAX_KEYWORDS; i++) {
+        token = &prompt->tokens[i];
+        word  = Tokenizer_Word(prompt, token);
+
+        /* Punctuation splits words as spaces do, so "yes,please" holds two keywords */
+        for (start = 0; start < token->length && count < MAX_KEYWORDS; start = end + 1) {
+            for (end = start; end < token->length && !Tokenizer_Is(word[end], kCharPunct); end++)
+                ;
+
+            /* Keywords are kept in lowercase for comparison */
+            length = end - start;
+            if (length > MAX_PATTERN_LENGTH - 1)
+                length = MAX_PATTERN_LENGTH - 1;
+            keyword = keywords[count].keyword;
+            for (j = 0; j < length; j++) {
+                keyword[j] = Tokenizer_Lower(word[start + j]);
+            }
+            keyword[length] = '\0';
 
-    /* Skip empty inputs */
-    if (!input || !*input) {
-        *keywordCount = 0;
-        return;
-    }
-
-    /* Copy input to buffer we can modify */
-    strncpy(buffer, input, kMaxPromptLength - 1);
-    buffer[kMaxPromptLength - 1] = '\0';
-
-    /* Tokenize the input */
-    token = strtok(buffer, " ,.!?;:\n\r\t");
-    while (token && count < MAX_KEYWORDS) {
-        /* Convert to lowercase for comparison */
-        char tokenLower[MAX_PATTERN_LENGTH];
-        strncpy(tokenLower, token, MAX_PATTERN_LENGTH - 1);
-        tokenLower[MAX_PATTERN_LENGTH - 1] = '\0';
-        ConvertToLowercase(tokenLower);
-
-        /* Skip very short words, common words, question words, etc. */
-        if (strlen(tokenLower) >= 3 &&
-            /* Articles, prepositions, conjunctions */
-            strcmp(tokenLower, "the") != 0 && strcmp(tokenLower, "and") != 0 &&
-            strcmp(tokenLower, "for") != 0 && strcmp(tokenLower, "that") != 0 &&
-            strcmp(tokenLower, "with") != 0 && strcmp(tokenLower, "but") != 0 &&
-            strcmp(tokenLower, "yet") != 0 && strcmp(tokenLower, "nor") != 0 &&
-            strcmp(tokenLower, "because") != 0 && strcmp(tokenLower, "from") != 0 &&
-            strcmp(tokenLower, "this") != 0 && strcmp(tokenLower, "these") != 0 &&
-            strcmp(tokenLower, "those") != 0 && strcmp(tokenLower, "there") != 0 &&
-            strcmp(tokenLower, "then") != 0 && strcmp(tokenLower, "than") != 0 &&
-            strcmp(tokenLower, "into") != 0 && strcmp(tokenLower, "onto") != 0 &&
-            strcmp(tokenLower, "upon") != 0 && strcmp(tokenLower, "over") != 0 &&
-            strcmp(tokenLower, "under") != 0 && strcmp(tokenLower, "above") != 0 &&
-            strcmp(tokenLower, "below") != 0 && strcmp(tokenLower, "near") != 0 &&
-
-            /* Question words */
-            strcmp(tokenLower, "what") != 0 && strcmp(tokenLower, "why") != 0 &&
-            strcmp(tokenLower, "how") != 0 && strcmp(tokenLower, "when") != 0 &&
-            strcmp(tokenLower, "where") != 0 && strcmp(tokenLower, "which") != 0 &&
-            strcmp(tokenLower, "who") != 0 && strcmp(tokenLower, "whose") != 0 &&
-            strcmp(tokenLower, "whom") != 0 && strcmp(tokenLower, "tell") != 0 &&
-            strcmp(tokenLower, "about") != 0 && strcmp(tokenLower, "explain") != 0 &&
-            strcmp(tokenLower, "describe") != 0 && strcmp(tokenLower, "show") != 0 &&
-            strcmp(tokenLower, "discuss") != 0 && strcmp(tokenLower, "define") != 0 &&
-
-            /* Common verbs */
-            strcmp(tokenLower, "are") != 0 && strcmp(tokenLower, "will") != 0 &&
-            strcmp(tokenLower, "does") != 0 && strcmp(tokenLower, "did") != 0 &&
-            strcmp(tokenLower, "can") != 0 && strcmp(tokenLower, "could") != 0 &&
-            strcmp(tokenLower, "would") != 0 && strcmp(tokenLower, "should") != 0 &&
-            strcmp(tokenLower, "may") != 0 && strcmp(tokenLower, "might") != 0 &&
-            strcmp(tokenLower, "have") != 0 && strcmp(tokenLower, "has") != 0 &&
-            strcmp(tokenLower, "had") != 0 && strcmp(tokenLower, "was") != 0 &&
-            strcmp(tokenLower, "were") != 0 && strcmp(tokenLower, "been") != 0 &&
-            strcmp(tokenLower, "being") != 0 && strcmp(tokenLower, "you") != 0 &&
-            strcmp(tokenLower, "not") != 0 && strcmp(tokenLower, "think") != 0 &&
-            strcmp(tokenLower, "know") != 0 && strcmp(tokenLower, "get") != 0 &&
-            strcmp(tokenLower, "see") != 0 && strcmp(tokenLower, "look") != 0 &&
-            strcmp(tokenLower, "make") != 0 && strcmp(tokenLower, "want") != 0 &&
-            strcmp(tokenLower, "come") != 0 && strcmp(tokenLower, "take") != 0 &&
-            strcmp(tokenLower, "use") != 0 && strcmp(tokenLower, "find") != 0 &&
-            strcmp(tokenLower, "give") != 0 && strcmp(tokenLower, "some") != 0 &&
-
-            /* Possessives and personal pronouns */
-            strcmp(tokenLower, "your") != 0 && strcmp(tokenLower, "yours") != 0 &&
-            strcmp(tokenLower, "our") != 0 && strcmp(tokenLower, "ours") != 0 &&
-            strcmp(tokenLower, "their") != 0 && strcmp(tokenLower, "theirs") != 0 &&
-            strcmp(tokenLower, "his") != 0 && strcmp(tokenLower, "her") != 0 &&
-            strcmp(tokenLower, "hers") != 0 && strcmp(tokenLower, "its") != 0 &&
-            strcmp(tokenLower, "mine") != 0 && strcmp(tokenLower, "they") != 0 &&
-            strcmp(tokenLower, "them") != 0 && strcmp(tokenLower, "she") != 0 &&
-            strcmp(tokenLower, "him") != 0 && strcmp(tokenLower, "one") != 0 &&
-            strcmp(tokenLower, "any") != 0 && strcmp(tokenLower, "all") != 0 &&
-            strcmp(tokenLower, "each") != 0 && strcmp(tokenLower, "both") != 0 &&
-            strcmp(tokenLower, "few") != 0 && strcmp(tokenLower, "many") != 0 &&
-            strcmp(tokenLower, "more") != 0 && strcmp(tokenLower, "most") != 0 &&
-            strcmp(tokenLower, "other") != 0 && strcmp(tokenLower, "such") != 0 &&
-            strcmp(tokenLower, "just") != 0 && strcmp(tokenLower, "very") != 0) {
-
-            /* Copy token to keyword array */
-            strncpy(keywords[count].keyword, tokenLower, MAX_PATTERN_LENGTH - 1);
-            keywords[count].keyword[MAX_PATTERN_LENGTH - 1] = '\0';
+            /* Skip very short words, common words, question words, etc. */
+            if (length < 3 || IsStopWord(keyword))
+                continue;
 
             /* Assign importance based on length and other factors */
-            keywords[count].importance = 50 + (strlen(tokenLower) * 5);
+            keywords[count].importance = 50 + (length * 5);
 
             /* Increase importance for technical and specific terms */
             if (strstr("mac|macintosh|system|file|disk|memory|error|help|app|window|program|"
                        "software|problem|computer|network",
-                       tokenLower)) {
+                       keyword)) {
                 keywords[count].importance += 50;
             }
 
             count++;
         }
-        token = strtok(NULL, " ,.!?;:\n\r\t");
     }
 
     *keywordCount = count;
 }
 
-/* Find the best template based on user input */
-static short FindBestTemplate(const char *userInput, const ExtractedKeyword *keywords,
+/* Find the best template based on user input, in lowercase. If the reply budget runs out part
+ * way through the database, the best of the templates scored so far is used */
+static short FindBestTemplate(const char *inputLower, const ExtractedKeyword *keywords,
                               short keywordCount)
 {
     short i, j, k;
@@ -325,11 +271,14 @@ static short FindBestTemplate(const char *userInput, const ExtractedKeyword *key
 
     /* First try to match based on patterns */
     for (i = 0; i < gTemplateCount; i++) {
+        if (i > 0 && i % kTemplatesPerBudgetCheck == 0 && ReplyBudget_Expired())
+            break;
+
         currentScore = 0;
 
         /* Check each pattern for this template */
         for (j = 0; j < gTemplates[i].patternCount; j++) {
-            if (PatternMatches(gTemplates[i].patterns[j], userInput)) {
+            if (strstr(inputLower, gTemplates[i].patterns[j]) != NULL) {
                 /* Pattern matched - add score based on pattern length */
                 currentScore += 100 + strlen(gTemplates[i].patterns[j]);
             }
@@ -366,7 +315,7 @@ static short FindBestTemplate(const char *userInput, const ExtractedKeyword *key
 
         /* Pick a random general template if available */
         if (generalCount > 0) {
-            bestIndex = generalTemplates[TemplateRandomGen() % generalCount];
+            bestIndex = generalTemplates[Random_Below(&gRandom, generalCount)];
         }
         else {
             /* Absolute fallback - first template */
@@ -377,16 +326,39 @@ static short FindBestTemplate(const char *userInput, const ExtractedKeyword *key
     return bestIndex;
 }
 
+/* Skip past the closing braces of a template slot */
+static const char *SkipSlot(const char *src)
+{
+    while (*src && *src != '}')
+        src++;
+    if (*src == '}')
+        src++; /* Skip first } */
+    if (*src == '}')
+        src++; /* Skip second } */
+    return src;
+}
+
+/* Append slot text, capitalizing it if it starts the response */
+static void AppendSlotText(TextBuilder *text, const char *slotText)
+{
+    if (text->length == 0 && *slotText >= 'a' && *slotText <= 'z') {
+        TextBuilder_AppendChar(text, *slotText - 32); /* Convert to uppercase */
+        slotText++;
+    }
+    TextBuilder_Append(text, slotText);
+}
+
 /* Fill template slots with keywords from user input */
 static void FillTemplate(char *response, const char *templateText, const ExtractedKeyword *keywords,
                          short keywordCount)
 {
     const char *src = templateText;
-    char *dst       = response;
+    TextBuilder text;
     short keywordIndex;
-    Boolean isFirstChar = true; /* Track if we're at the first character of the response */
 
-    while (*src && (dst - response) < kMaxPromptLength - 1) {
+    TextBuilder_Init(&text, response, kMaxPromptLength);
+
+    while (*src && TextBuilder_Remaining(&text) > 0) {
         if (*src == '{' && *(src + 1) == '{') {
             /* Found a template slot */
             src += 2; /* Skip {{ */
@@ -401,49 +373,14 @@ static void FillTemplate(char *response, const char *templateText, const Extract
                     keywordIndex = *src - '0';
                     src++;
                 }
+                src = SkipSlot(src);
 
-                /* Skip to end of slot marker */
-                while (*src && *src != '}')
-                    src++;
-                if (*src == '}')
-                    src++; /* Skip first } */
-                if (*src == '}')
-                    src++; /* Skip second } */
-
-                /* Insert the keyword if available */
+                /* Insert the keyword if available, otherwise a placeholder */
                 if (keywordIndex < keywordCount) {
-                    /* If this is the first character of the response, capitalize the keyword */
-                    if (isFirstChar && keywords[keywordIndex].keyword[0] != '\0') {
-                        /* Copy first character uppercase */
-                        if (keywords[keywordIndex].keyword[0] >= 'a' &&
-                            keywords[keywordIndex].keyword[0] <= 'z') {
-                            *dst++ =
-                                keywords[keywordIndex].keyword[0] - 32; /* Convert to uppercase */
-                        }
-                        else {
-                            *dst++ = keywords[keywordIndex]
-                                         .keyword[0]; /* Already uppercase or non-alpha */
-                        }
-                        /* Copy the rest of the keyword */
-                        strcpy(dst, keywords[keywordIndex].keyword + 1);
-                        dst += strlen(keywords[keywordIndex].keyword) - 1;
-                        isFirstChar = false;
-                    }
-                    else {
-                        strcpy(dst, keywords[keywordIndex].keyword);
-                        dst += strlen(keywords[keywordIndex].keyword);
-                    }
+                    AppendSlotText(&text, keywords[keywordIndex].keyword);
                 }
                 else {
-                    /* No keyword available, insert placeholder */
-                    if (isFirstChar) {
-                        strcpy(dst, "That"); /* Capitalized */
-                        isFirstChar = false;
-                    }
-                    else {
-                        strcpy(dst, "that");
-                    }
-                    dst += 4;
+                    AppendSlotText(&text, "that");
                 }
             }
             else if (strncmp(src, "time", 4) == 0) {
@@ -453,18 +390,8 @@ static void FillTemplate(char *response, const char *templateText, const Extract
 
                 GetTime(&dateTime);
                 sprintf(timeStr, "%d:%02d", dateTime.hour, dateTime.minute);
-
-                strcpy(dst, timeStr);
-                dst += strlen(timeStr);
-                isFirstChar = false;
-
-                /* Skip to end of slot marker */
-                while (*src && *src != '}')
-                    src++;
-                if (*src == '}')
-                    src++; /* Skip first } */
-                if (*src == '}')
-                    src++; /* Skip second } */
+                TextBuilder_Append(&text, timeStr);
+                src = SkipSlot(src);
             }
             else if (strncmp(src, "date", 4) == 0) {
                 /* Insert current date */
@@ -477,55 +404,33 @@ static void FillTemplate(char *response, const char *templateText, const Extract
                 GetTime(&dateTime);
                 sprintf(dateStr, "%s %d, %d", monthNames[dateTime.month - 1], dateTime.day,
                         dateTime.year);
-
-                strcpy(dst, dateStr);
-                dst += strlen(dateStr);
-                isFirstChar = false;
-
-                /* Skip to end of slot marker */
-                while (*src && *src != '}')
-                    src++;
-                if (*src == '}')
-                    src++; /* Skip first } */
-                if (*src == '}')
-                    src++; /* Skip second } */
+                TextBuilder_Append(&text, dateStr);
+                src = SkipSlot(src);
             }
             else {
                 /* Unknown slot type, just skip it */
-                while (*src && *src != '}')
-                    src++;
-                if (*src == '}')
-                    src++; /* Skip first } */
-                if (*src == '}')
-                    src++; /* Skip second } */
+                src = SkipSlot(src);
             }
         }
         else {
-            /* Regular character, copy it */
-            if (isFirstChar && *src >= 'a' && *src <= 'z') {
-                /* Capitalize first character of the response */
-                *dst++      = *src - 32; /* Convert to uppercase */
-                isFirstChar = false;
+            /* Regular character, copy it, capitalizing the first character of the response */
+            if (text.length == 0 && *src >= 'a' && *src <= 'z') {
+                TextBuilder_AppendChar(&text, *src - 32); /* Convert to uppercase */
             }
             else {
-                *dst++ = *src;
-                if (isFirstChar) {
-                    isFirstChar = false;
-                }
+                TextBuilder_AppendChar(&text, *src);
             }
             src++;
         }
     }
-
-    /* Ensure null termination */
-    *dst = '\0';
 }
 
 /* Initialize the Template-based model */
 void InitTemplateModel(void)
 {
-    /* Initialize random number generator */
-    InitRandom();
+    /* Seeded once, so switching models back and forth doesn't replay the same replies */
+    if (gRandom.state == 0)
+        Random_Seed(&gRandom, Random_SessionSeed(), kRandomStreamTemplate);
 
     /* Reset template count */
     gTemplateCount = 0;
@@ -538,45 +443,38 @@ void InitTemplateModel(void)
 }
 
 /* Generate a template-based AI response */
-char *GenerateTemplateResponse(const ConversationHistory *history)
+char *GenerateTemplateResponse(const TokenList *prompt)
 {
     static char response[512];
+    char inputLower[kMaxPromptLength];
     ExtractedKeyword keywords[MAX_KEYWORDS];
     short keywordCount = 0;
     short templateIndex;
-    const char *userMessage = NULL;
 
     /* Initialize with default response in case something goes wrong */
     strcpy(response, "I'm thinking about how to respond...");
 
-    /* Check history is valid and get last user message */
-    if (history != NULL && history->count > 0) {
-        short i;
-        for (i = history->count - 1; i >= 0; i--) {
-            short idx = (history->head + i) % kMaxConversationHistory;
-            if (history->messages[idx].type == kUserMessage) {
-                userMessage = history->messages[idx].text;
-                break;
-            }
-        }
-
-        if (userMessage && *userMessage) {
-            /* Extract keywords from user input */
-            ExtractKeywords(userMessage, keywords, &keywordCount);
+    if (prompt != NULL && prompt->count > 0) {
+        /* Patterns are matched against the whole input, lowercased once for all of them */
+        strncpy(inputLower, prompt->text, kMaxPromptLength - 1);
+        inputLower[kMaxPromptLength - 1] = '\0';
+        ConvertToLowercase(inputLower);
 
-            /* Find the best matching template */
-            templateIndex = FindBestTemplate(userMessage, keywords, keywordCount);
+        /* Extract keywords from user input */
+        ExtractKeywords(prompt, keywords, &keywordCount);
 
-            if (templateIndex >= 0) {
-                /* Fill the template with keywords from user input */
-                FillTemplate(response, gTemplates[templateIndex].response, keywords, keywordCount);
-            }
+        /* Find the best matching template */
+        templateIndex = FindBestTemplate(inputLower, keywords, keywordCount);
 
-            return response;
+        if (templateIndex >= 0) {
+            /* Fill the template with keywords from user input */
+            FillTemplate(response, gTemplates[templateIndex].response, keywords, keywordCount);
         }
+
+        return response;
     }
 
     /* Fallback response if no user message found */
     strcpy(response, "Hello! I'm your Macintosh AI assistant. How can I help you today?");
     return response;
-}
\ No newline at end of file
+}
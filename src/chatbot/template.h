@@ -9,7 +9,8 @@ void InitTemplateModel(void);
 /* Add dynamic system information templates */
 void AddDynamicSystemTemplates(void);
 
-/* Generate a template-based AI response */
-char *GenerateTemplateResponse(const ConversationHistory *history);
+/* Generate a template-based reply to the user's last message, split into tokens, or a greeting
+ * if prompt is NULL */
+char *GenerateTemplateResponse(const TokenList *prompt);
 
 #endif /* TEMPLATE_H */
\ No newline at end of file
@@ -0,0 +1,100 @@
+#include <string.h>
+
+#include "text_builder.h"
+
+/* Check if a char is sentence ending punctuation */
+static Boolean IsSentenceEnder(char c)
+{
+    return (c == '.' || c == '!' || c == '?');
+}
+
+/* Mark everything so far as complete sentences */
+static void CompleteSentence(TextBuilder *builder)
+{
+    builder->sentenceCount++;
+    builder->sentenceStart = builder->length;
+    builder->sentenceWords = 0;
+}
+
+/* Start building into a buffer of capacity bytes */
+void TextBuilder_Init(TextBuilder *builder, char *buffer, short capacity)
+{
+    builder->text          = buffer;
+    builder->length        = 0;
+    builder->capacity      = capacity;
+    builder->sentenceCount = 0;
+    builder->sentenceStart = 0;
+    builder->sentenceWords = 0;
+
+    if (capacity > 0)
+        buffer[0] = '\0';
+}
+
+/* Characters that can still be appended */
+short TextBuilder_Remaining(const TextBuilder *builder)
+{
+    return (builder->capacity > 0) ? builder->capacity - 1 - builder->length : 0;
+}
+
+/* Append one character, returns FALSE if there was no room */
+Boolean TextBuilder_AppendChar(TextBuilder *builder, char c)
+{
+    if (TextBuilder_Remaining(builder) < 1)
+        return FALSE;
+
+    builder->text[builder->length++] = c;
+    builder->text[builder->length]   = '\0';
+    return TRUE;
+}
+
+/* Append text, returns FALSE if it had to be cut short */
+Boolean TextBuilder_Append(TextBuilder *builder, const char *text)
+{
+    size_t len       = strlen(text);
+    short remaining  = TextBuilder_Remaining(builder);
+    Boolean complete = TRUE;
+
+    if (len > (size_t)remaining) {
+        len      = remaining;
+        complete = FALSE;
+    }
+
+    memcpy(&builder->text[builder->length], text, len);
+    builder->length += len;
+    if (builder->capacity > 0)
+        builder->text[builder->length] = '\0';
+    return complete;
+}
+
+/* Append a word, separated by a space unless it starts the text */
+Boolean TextBuilder_AppendWord(TextBuilder *builder, const char *word)
+{
+    size_t len = strlen(word);
+
+    if (builder->length > 0 && builder->text[builder->length - 1] != ' ' &&
+        !TextBuilder_AppendChar(builder, ' '))
+        return FALSE;
+
+    if (!TextBuilder_Append(builder, word))
+        return FALSE;
+
+    builder->sentenceWords++;
+    if (len > 0 && IsSentenceEnder(word[len - 1]))
+        CompleteSentence(builder);
+    return TRUE;
+}
+
+/* Complete the current sentence, adding a period if it doesn't already end with punctuation */
+void TextBuilder_EndSentence(TextBuilder *builder)
+{
+    /* Nothing since the last sentence ended */
+    if (builder->length == builder->sentenceStart)
+        return;
+
+    if (!IsSentenceEnder(builder->text[builder->length - 1]) &&
+        !TextBuilder_AppendChar(builder, '.')) {
+        /* Full: make room for the period by dropping the last character */
+        builder->text[builder->length - 1] = '.';
+    }
+    CompleteSentence(builder);
+}
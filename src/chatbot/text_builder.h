@@ -0,0 +1,36 @@
+#ifndef TEXT_BUILDER_H
+#define TEXT_BUILDER_H
+
+#include "portable.h"
+
+/* Bounded output buffer that tracks its own length, so building a reply is linear in its size.
+ * The text is always NUL-terminated; appends that don't fit are cut short */
+typedef struct {
+    char *text;          /* Caller's buffer */
+    short length;        /* Characters in text, not counting the terminator */
+    short capacity;      /* Size of the buffer, including the terminator */
+    short sentenceCount; /* Sentences completed so far */
+    short sentenceStart; /* Offset where the current sentence begins */
+    short sentenceWords; /* Words in the current sentence */
+} TextBuilder;
+
+/* Start building into a buffer of capacity bytes */
+void TextBuilder_Init(TextBuilder *builder, char *buffer, short capacity);
+
+/* Characters that can still be appended */
+short TextBuilder_Remaining(const TextBuilder *builder);
+
+/* Append one character, returns FALSE if there was no room */
+Boolean TextBuilder_AppendChar(TextBuilder *builder, char c);
+
+/* Append text, returns FALSE if it had to be cut short */
+Boolean TextBuilder_Append(TextBuilder *builder, const char *text);
+
+/* Append a word, separated by a space unless it starts the text. A word ending with sentence
+ * punctuation completes the sentence. Returns FALSE if it had to be cut short */
+Boolean TextBuilder_AppendWord(TextBuilder *builder, const char *word);
+
+/* Complete the current sentence, adding a period if it doesn't already end with punctuation */
+void TextBuilder_EndSentence(TextBuilder *builder);
+
+#endif /* TEXT_BUILDER_H */
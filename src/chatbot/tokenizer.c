@@ -0,0 +1,138 @@
+#include <stddef.h>
+#include <string.h>
+
+#include "tokenizer.h"
+
+/* Offsets are unsigned shorts, so a list stops taking words this far into the text */
+#define kMaxTokenOffset (0xFFFF - kMaxTokenLength)
+
+#define C kCharControl
+#define S kCharSpace
+#define P kCharPunct
+#define E (kCharEnder | kCharPunct)
+#define D kCharAlnum
+#define U (kCharUpper | kCharAlnum)
+
+/* Classes of the ASCII characters; the rest, such as accented letters, are plain word characters */
+const unsigned char gCharClass[256] = {
+    C, C, C, C, C, C, C, C, C, S, S, C, C, S, C, C, /* Tab, line feed and return are spaces */
+    C, C, C, C, C, C, C, C, C, C, C, C, C, C, C, C, /* */
+    S, E, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, P, 0, E, 0, /* Space ! " # $ % & ' ( ) * + , - . / */
+    D, D, D, D, D, D, D, D, D, D, P, P, 0, 0, 0, E, /* 0 to 9 : ; < = > ? */
+    0, U, U, U, U, U, U, U, U, U, U, U, U, U, U, U, /* @ A to O */
+    U, U, U, U, U, U, U, U, U, U, U, 0, 0, 0, 0, 0, /* P to Z [ \ ] ^ _ */
+    0, D, D, D, D, D, D, D, D, D, D, D, D, D, D, D, /* ` a to o */
+    D, D, D, D, D, D, D, D, D, D, D, 0, 0, 0, 0, C  /* p to z { | } ~ Delete */
+};
+
+#undef C
+#undef S
+#undef P
+#undef E
+#undef D
+#undef U
+
+/* Hash length characters of text in lowercase, the same way token keys are hashed */
+unsigned short Tokenizer_Hash(const char *text, short length)
+{
+    unsigned short hash = 0;
+    short i;
+
+    for (i = 0; i < length; i++) {
+        hash = hash * 31 + (unsigned char)Tokenizer_Lower(text[i]);
+    }
+    return hash;
+}
+
+/* Split text into a list of tokens, returns how many characters were split */
+long Tokenizer_Split(TokenList *list, const char *text)
+{
+    const char *p = text;
+    const char *word;
+    Token *token;
+    long length;
+    short keyLength;
+
+    list->text  = text;
+    list->count = 0;
+    for (;;) {
+        while (Tokenizer_Is(*p, kCharSpace)) {
+            p++;
+        }
+        if (*p == '\0' || list->count == kMaxTokens || p - text > kMaxTokenOffset)
+            return p - text;
+
+        word = p;
+        while (*p != '\0' && !Tokenizer_Is(*p, kCharSpace)) {
+            p++;
+        }
+        length = p - word;
+        if (length > kMaxTokenLength)
+            length = kMaxTokenLength;
+
+        /* The key keeps at least one character, so a word of punctuation still has one */
+        for (keyLength = length; keyLength > 1 && Tokenizer_Is(word[keyLength - 1], kCharPunct);
+             keyLength--)
+            ;
+
+        token            = &list->tokens[list->count++];
+        token->offset    = word - text;
+        token->length    = length;
+        token->keyLength = keyLength;
+        token->hash      = Tokenizer_Hash(word, keyLength);
+    }
+}
+
+/* Check whether a token's key is a lowercase word */
+Boolean Tokenizer_KeyIs(const TokenList *list, const Token *token, const char *word)
+{
+    const char *key = Tokenizer_Word(list, token);
+    short i;
+
+    for (i = 0; i < token->keyLength; i++) {
+        if (word[i] != Tokenizer_Lower(key[i]))
+            return FALSE;
+    }
+    return word[i] == '\0';
+}
+
+/* Check whether a token's key is one of a NULL terminated list of lowercase words */
+Boolean Tokenizer_KeyIn(const TokenList *list, const Token *token, const char *const *words)
+{
+    const char *key = Tokenizer_Word(list, token);
+    char first      = Tokenizer_Lower(key[0]);
+    short i;
+
+    for (i = 0; words[i] != NULL; i++) {
+        if (words[i][0] == first && Tokenizer_KeyIs(list, token, words[i]))
+            return TRUE;
+    }
+    return FALSE;
+}
+
+/* Copy the first length characters of a token as written */
+short Tokenizer_CopyWord(const TokenList *list, const Token *token, short length, char *buffer,
+                         short size)
+{
+    if (length > size - 1)
+        length = size - 1;
+    memcpy(buffer, Tokenizer_Word(list, token), length);
+    buffer[length] = '\0';
+    return length;
+}
+
+/* Copy a token's key in lowercase */
+short Tokenizer_CopyKey(const TokenList *list, const Token *token, char *buffer, short size)
+{
+    const char *key = Tokenizer_Word(list, token);
+    short length    = token->keyLength;
+    short i;
+
+    if (length > size - 1)
+        length = size - 1;
+    for (i = 0; i < length; i++) {
+        buffer[i] = Tokenizer_Lower(key[i]);
+    }
+    buffer[length] = '\0';
+    return length;
+}
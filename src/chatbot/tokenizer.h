@@ -0,0 +1,63 @@
+#ifndef TOKENIZER_H
+#define TOKENIZER_H
+
+#include "portable.h"
+
+/* Splits text into words once, for every engine to share. Words are runs of characters between
+ * spaces. A token points into the text rather than copying it, and carries the word's key: the
+ * word in lowercase less any trailing punctuation, as a length and a hash. Nothing is kept
+ * between calls, so any number of lists can be in use at once */
+#define kMaxTokens 128      /* Words in one list; a prompt of kMaxPromptLength has at most this */
+#define kMaxTokenLength 255 /* Longer words are cut short */
+
+/* Character classes, as bits */
+enum {
+    kCharSpace   = 0x01, /* Separates words */
+    kCharEnder   = 0x02, /* Ends a sentence: . ! ? */
+    kCharPunct   = 0x04, /* Trimmed from the end of a key: . , ! ? ; : */
+    kCharUpper   = 0x08, /* A to Z */
+    kCharAlnum   = 0x10, /* Letters and digits */
+    kCharControl = 0x20  /* Control characters other than spaces */
+};
+
+extern const unsigned char gCharClass[256];
+
+#define Tokenizer_Is(c, classes) ((gCharClass[(unsigned char)(c)] & (classes)) != 0)
+#define Tokenizer_Lower(c) (Tokenizer_Is(c, kCharUpper) ? (char)((c) + 32) : (c))
+
+typedef struct {
+    unsigned short offset;   /* Of the word's first character in the text */
+    unsigned char length;    /* Up to the next space, punctuation included */
+    unsigned char keyLength; /* Less trailing punctuation, but never 0 */
+    unsigned short hash;     /* Of the key in lowercase */
+} Token;
+
+typedef struct {
+    const char *text; /* Not copied, so it must not change while the list is used */
+    short count;
+    Token tokens[kMaxTokens];
+} TokenList;
+
+/* Split text into a list of tokens, returns how many characters were split. That is all of
+ * them unless the list filled up, in which case the rest can be split by another call */
+long Tokenizer_Split(TokenList *list, const char *text);
+
+/* Hash length characters of text in lowercase, the same way token keys are hashed */
+unsigned short Tokenizer_Hash(const char *text, short length);
+
+/* Point to a token's first character */
+#define Tokenizer_Word(list, token) ((list)->text + (token)->offset)
+
+/* Check whether a token's key is a lowercase word */
+Boolean Tokenizer_KeyIs(const TokenList *list, const Token *token, const char *word);
+
+/* Check whether a token's key is one of a NULL terminated list of lowercase words */
+Boolean Tokenizer_KeyIn(const TokenList *list, const Token *token, const char *const *words);
+
+/* Copy the first length characters of a token as written, or its key in lowercase, to a buffer
+ * of size characters. Both are cut short to fit; returns the length copied */
+short Tokenizer_CopyWord(const TokenList *list, const Token *token, short length, char *buffer,
+                         short size);
+short Tokenizer_CopyKey(const TokenList *list, const Token *token, char *buffer, short size);
+
+#endif /* TOKENIZER_H */
@@ -29,6 +29,7 @@ enum {
     kItemMarkovModel   = 1,
     kItemOpenAIModel   = 2,
     kItemTemplateModel = 3,
+    kItemLearnFromChat = 5,
     
     /* Extras menu items */
     kItemPlayMusic = 1,
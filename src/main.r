@@ -3,6 +3,9 @@
 #include "Windows.r"
 #include "Dialogs.r"
 
+/* Precompiled Markov model, generated into the build directory by tools/markov_train */
+#include "markov_model.r"
+
 /* Apple menu */
 resource 'MENU' (128) {
     128, textMenuProc;
@@ -36,6 +39,8 @@ resource 'MENU' (130) {
         "Markov Chain", noIcon, noKey, noMark, plain;
         "OpenAI", noIcon, noKey, noMark, plain;
         "Template", noIcon, noKey, noMark, plain;
+        "-", noIcon, noKey, noMark, plain;
+        "Learn From Chat", noIcon, noKey, noMark, plain;
     }
 };
 
@@ -247,6 +252,6 @@ resource 'SIZE' (-1) {
     reserved,
     reserved,
     reserved,
-    512 * 1024,   /* Minimal memory size for Markov chain and conversation history */
-    768 * 1024    /* Preferred memory size with buffer for generation and UI */
+    512 * 1024,   /* Minimal memory size; the chain the precompiled Markov model needs */
+    1024 * 1024   /* Preferred memory size; the extra lets the chain learn more */
 };
\ No newline at end of file
@@ -15,6 +15,9 @@
 #include "chat_window.h"
 #include "utils.h"
 
+/* Longest message shown. Replies and debug command output can run well past a prompt */
+#define kMaxMessageLength 1024
+
 /* Module variables */
 static WindowRef sWindow    = NULL;
 static Boolean sInitialized = false;
@@ -622,7 +625,7 @@ static void ClearChatInput(void)
 /* Format a new message with proper styling */
 static void FormatAndAddMessage(const char *message, Boolean isUserMessage)
 {
-    char formattedMsg[kMaxPromptLength + 100]; /* Extra space for formatting */
+    char formattedMsg[kMaxMessageLength + 100]; /* Extra space for formatting */
     short msgLength;
     static Boolean isAdding = false;
 
@@ -634,7 +637,7 @@ static void FormatAndAddMessage(const char *message, Boolean isUserMessage)
     isAdding = true;
 
     /* Safety check for message length */
-    if (strlen(message) == 0 || strlen(message) >= kMaxPromptLength) {
+    if (strlen(message) == 0 || strlen(message) >= kMaxMessageLength) {
         isAdding = false;
         return;
     }
@@ -1,6 +1,7 @@
 #include <Events.h>
 #include <Windows.h>
 
+#include "../chatbot/model_manager.h"
 #include "../constants.h"
 #include "../error.h"
 #include "../sound/tetris.h"
@@ -21,6 +22,9 @@ void QuitApplication(Boolean saveChanges)
     TetrisStopMusic();
     TetrisAudioCleanup();
 
+    /* Keep what the Markov chain learned for the next launch */
+    SaveModels();
+
     /* Clean up windows through the window manager */
     WindowManager_Dispose();
 
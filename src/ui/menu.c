@@ -55,6 +55,13 @@ void UpdateMenus(void)
         CheckItem(modelsMenu, kItemOpenAIModel, gActiveAIModel == kOpenAIModel);
         CheckItem(modelsMenu, kItemTemplateModel, gActiveAIModel == kTemplateModel);
 
+        /* Only the Markov chain can learn from the conversation */
+        if (gActiveAIModel == kMarkovModel)
+            EnableItem(modelsMenu, kItemLearnFromChat);
+        else
+            DisableItem(modelsMenu, kItemLearnFromChat);
+        CheckItem(modelsMenu, kItemLearnFromChat, IsMarkovLearning());
+
         break;
     }
 }
@@ -148,6 +155,15 @@ void DoMenuCommand(long menuCommand)
                     SetActiveAIModel(kTemplateModel);
                     ChatWindow_AddMessage("Switched to Template-based model.", false);
                     break;
+
+                case kItemLearnFromChat:
+                    /* Toggle training the Markov chain on what the user types */
+                    SetMarkovLearning(!IsMarkovLearning());
+                    if (IsMarkovLearning())
+                        ChatWindow_AddMessage("Learning from this conversation.", false);
+                    else
+                        ChatWindow_AddMessage("Stopped learning from this conversation.", false);
+                    break;
                 }
 
                 /* Update menu to show check mark next to active model */
@@ -3,6 +3,7 @@
 #include <Menus.h>
 #include <Windows.h>
 
+#include "../chatbot/model_manager.h"
 #include "../constants.h"
 #include "../error.h"
 #include "about_window.h"
@@ -375,6 +376,9 @@ void WindowManager_HandleEvent(EventRecord *event)
 /* Perform idle-time processing */
 void WindowManager_Idle(void)
 {
+    /* Models train in the background whichever window is in front */
+    IdleModels();
+
     /* Only need idle processing for chat window */
     if (gForegroundWindowType == kWindowTypeChat && gWindowModules[kWindowTypeChat].initialized &&
         gWindowModules[kWindowTypeChat].visible) {
@@ -0,0 +1,400 @@
+/* Host-side Markov generation benchmark
+ *
+ * Generates ever longer random walks over the static corpus, appending each word the way the
+ * app used to (strlen plus strcat) and with TextBuilder. Time per word should stay flat for
+ * TextBuilder and grow with the output length for strcat.
+ *
+ * Then times the app's own replies, through MarkovReply_Generate, to a few fixed prompts with
+ * best-of-N candidates for growing N. The reply budget is lifted so every candidate is made. The
+ * cost per reply should grow linearly with N; scale it by the host's speed over a 68030's to
+ * check N still fits the app's time budget.
+ *
+ * Last, compares sampled sentences with beam search decoded ones of growing width, expanded by
+ * sampled followers as in the app: how likely the chain finds them per word, and what each
+ * sentence costs.
+ *
+ * The state lookups all that generation made are reported too, as probes per lookup.
+ *
+ * Every measurement restarts the random stream from the seed (-s, 1 by default), so the words
+ * generated are the same on every run. The replies' checksum shows whether a change to the
+ * chain or the sampler changed what it generates.
+ *
+ * Last come checks of behavior the timings can't show; the exit status is 1 if any fails.
+ * Changing the sampling settings must rebuild the chain's cached sampling tables, and beam
+ * decoded replies to one prompt must differ.
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "markov_beam.h"
+#include "markov_chain.h"
+#include "markov_data.h"
+#include "markov_reply.h"
+#include "random.h"
+#include "reply_budget.h"
+#include "text_builder.h"
+
+#define kMaxOutput 32767        /* Longest walk timed, in characters (TextBuilder uses shorts) */
+#define kRepeats 20             /* Walks per measurement, to get above clock resolution */
+#define kReplies 2000           /* Replies per best-of-N measurement */
+#define kUnlimitedBudget 60000L /* Reply budget while timing replies, in milliseconds */
+#define kBenchPrompts 5         /* Prompts the replies answer in turn */
+#define kSentences 2000         /* Sentences per beam width measurement */
+#define kBeamLengthPenalty 70   /* As in the app */
+#define kCheckDraws 1000        /* Followers drawn per sampling setting checked */
+#define kCheckReplies 20        /* Beam decoded replies to one prompt checked for variety */
+#define kCheckBeamWidth 4       /* Width those replies are decoded at */
+
+/* The chain being walked */
+static MarkovChain *gChain;
+
+/* Corpus files call this for every training sentence */
+void TrainMarkov(const char *text)
+{
+    MarkovChain_Train(gChain, text);
+}
+
+/* Deterministic random numbers, so both methods walk the same words */
+static unsigned long gSeed = kRandomFixedSeed;
+static RandomStream gRandom;
+
+/* Checksum of every reply generated, to compare runs */
+static unsigned long gReplyChecksum;
+
+/* What the replies answer: keywords, a topic, a sentence to finish, and nothing at all */
+static const char *const kPrompts[kBenchPrompts] = {
+    "Tell me about the Macintosh", "How does music affect the brain?", "What should I cook?",
+    "My favorite thing to do is...", NULL};
+
+/* Make a word the newest of the recent words */
+static void PushWord(WordID *recentWords, short *recentCount, WordID word)
+{
+    short i;
+
+    for (i = (*recentCount < MARKOV_ORDER) ? *recentCount : MARKOV_ORDER - 1; i > 0; i--) {
+        recentWords[i] = recentWords[i - 1];
+    }
+    recentWords[0] = word;
+    if (*recentCount < MARKOV_ORDER)
+        (*recentCount)++;
+}
+
+/* Pick the next word of a walk, starting a new sentence at a sentence end or a dead end */
+static WordID NextWord(WordID *recentWords, short *recentCount)
+{
+    short state = MarkovChain_FindContext(gChain, recentWords, *recentCount);
+    WordID word = (state >= 0) ? MarkovChain_SampleFollower(gChain, state, &gRandom) : kNoWord;
+
+    if (word == kNoWord || word == kSentenceEnd) {
+        *recentCount = 0;
+        PushWord(recentWords, recentCount, kSentenceStart);
+        state = MarkovChain_FindContext(gChain, recentWords, *recentCount);
+        word  = MarkovChain_SampleFollower(gChain, state, &gRandom);
+    }
+
+    PushWord(recentWords, recentCount, word);
+    return word;
+}
+
+/* Walk until the output reaches length characters, returns the number of words */
+static long Walk(char *buffer, long length, int useBuilder)
+{
+    WordID recentWords[MARKOV_ORDER];
+    short recentCount = 0;
+    TextBuilder text;
+    long words = 0;
+    const char *word;
+
+    Random_Seed(&gRandom, gSeed, kRandomStreamBench);
+    buffer[0] = '\0';
+    TextBuilder_Init(&text, buffer, (short)length);
+
+    for (;;) {
+        word = MarkovChain_WordText(gChain, NextWord(recentWords, &recentCount));
+
+        if (useBuilder) {
+            if (TextBuilder_Remaining(&text) < MAX_WORD_LENGTH + 1)
+                break;
+            TextBuilder_AppendWord(&text, word);
+        }
+        else {
+            /* The pattern the generators used: strlen in the loop test, strcat per word */
+            if ((long)strlen(buffer) >= length - MAX_WORD_LENGTH - 1)
+                break;
+            strcat(buffer, " ");
+            strcat(buffer, word);
+        }
+        words++;
+    }
+    return words;
+}
+
+/* Time the app's best-of-N replies for growing N */
+static void BenchCandidates(void)
+{
+    static TokenList prompts[kBenchPrompts];
+    MarkovMixture mixture;
+    const TokenList *prompt;
+    const char *reply;
+    long words;
+    int candidates, i, j;
+    clock_t start;
+    double seconds;
+
+    /* A mixture of the general chain alone, as when a prompt names no topic */
+    MarkovMixture_Init(&mixture);
+    MarkovMixture_Add(&mixture, gChain, 100);
+    for (i = 0; i < kBenchPrompts; i++) {
+        if (kPrompts[i] != NULL)
+            Tokenizer_Split(&prompts[i], kPrompts[i]);
+    }
+    SetReplyBudget(kUnlimitedBudget);
+
+    printf("\n%8s %14s %14s %14s\n", "N", "words/reply", "us/candidate", "us/reply");
+    for (candidates = 1; candidates <= kMaxCandidates; candidates *= 2) {
+        Random_Seed(&gRandom, gSeed, kRandomStreamBench);
+        words = 0;
+        start = clock();
+        for (i = 0; i < kReplies; i++) {
+            prompt = (kPrompts[i % kBenchPrompts] != NULL) ? &prompts[i % kBenchPrompts] : NULL;
+
+            ReplyBudget_Start();
+            reply = MarkovReply_Generate(&mixture, prompt, candidates, 1, &gRandom);
+            ReplyBudget_Finish();
+
+            for (j = 0; reply[j] != '\0'; j++) {
+                if (reply[j] == ' ')
+                    words++;
+                gReplyChecksum = (gReplyChecksum * 31 + (unsigned char)reply[j]) & 0xFFFFFFFFUL;
+            }
+            words++;
+        }
+        seconds = (double)(clock() - start) / CLOCKS_PER_SEC;
+
+        printf("%8d %14.1f %14.1f %14.1f\n", candidates, (double)words / kReplies,
+               seconds * 1e6 / ((double)kReplies * candidates), seconds * 1e6 / kReplies);
+    }
+}
+
+/* Decode or sample one sentence from the start marker, returns its words, the end marker
+ * included; adds the log probability of each to logProb */
+static short Sentence(MarkovBeamPool *pool, short width, long *logProb)
+{
+    WordID recentWords[MARKOV_MAX_ORDER], words[kMaxBeamWords];
+    short logProbs[kMaxBeamWords];
+    short recentCount = 0, count, state, i;
+    MarkovMixture mixture;
+
+    PushWord(recentWords, &recentCount, kSentenceStart);
+
+    if (width > 1) {
+        /* A mixture of one chain decodes exactly as the chain alone */
+        MarkovMixture_Init(&mixture);
+        MarkovMixture_Add(&mixture, gChain, 100);
+        count = MarkovBeam_Decode(&mixture, pool, recentWords, recentCount, width,
+                                  kBeamLengthPenalty, &gRandom, words, logProbs);
+    }
+    else {
+        count = 0;
+        while (count < kMaxBeamWords &&
+               (state = MarkovChain_FindContext(gChain, recentWords, recentCount)) >= 0) {
+            words[count] = MarkovChain_SampleFollowerScored(gChain, state, &gRandom,
+                                                            &logProbs[count]);
+            PushWord(recentWords, &recentCount, words[count]);
+            if (words[count++] == kSentenceEnd)
+                break;
+        }
+    }
+
+    for (i = 0; i < count; i++) {
+        *logProb += logProbs[i];
+    }
+    return count;
+}
+
+/* Time sampled sentences against beam search decoded ones */
+static void BenchBeam(void)
+{
+    static MarkovBeamPool pool;
+    long words, logProb;
+    int width, i;
+    clock_t start;
+    double seconds;
+
+    printf("\n%8s %14s %14s %14s\n", "width", "words/sent", "bits/word", "us/sentence");
+    for (width = 1; width <= kMaxBeamWidth; width *= 2) {
+        Random_Seed(&gRandom, gSeed, kRandomStreamBench);
+        words   = 0;
+        logProb = 0;
+        start   = clock();
+        for (i = 0; i < kSentences; i++) {
+            words += Sentence(&pool, width, &logProb);
+        }
+        seconds = (double)(clock() - start) / CLOCKS_PER_SEC;
+
+        printf("%8d %14.1f %14.2f %14.1f\n", width, (double)words / kSentences,
+               (double)logProb / kLogProbScale / (double)words, seconds * 1e6 / kSentences);
+    }
+}
+
+/* Print how long state lookups took while generating, which decides the index size */
+static void PrintLookups(void)
+{
+    MarkovChainStats stats;
+
+    MarkovChain_GetStats(gChain, &stats);
+    printf("\n%d states in %d slots: %lu lookups, %.2f probes on average, %u at most\n",
+           stats.nodeCount, stats.lookup.tableSize, stats.lookup.lookups,
+           (stats.lookup.lookups > 0) ? (double)stats.lookup.probes / stats.lookup.lookups : 0.0,
+           stats.lookup.maxProbes);
+}
+
+/* Draw followers of a state, returns how many were the given word; counts the distinct ones */
+static long DrawFollowers(short state, WordID word, short *distinct)
+{
+    static unsigned char seen[kMarkovMaxWords + 1];
+    long hits = 0;
+    WordID drawn;
+    int i;
+
+    memset(seen, 0, sizeof(seen));
+    *distinct = 0;
+    for (i = 0; i < kCheckDraws; i++) {
+        drawn = MarkovChain_SampleFollower(gChain, state, &gRandom);
+        if (drawn == word)
+            hits++;
+        if (drawn != kNoWord && !seen[drawn]) {
+            seen[drawn] = TRUE;
+            (*distinct)++;
+        }
+    }
+    return hits;
+}
+
+/* Check that the sampling settings take effect on tables already built: top-k 1 draws only the
+ * most likely sentence start, a low temperature favors it over the trained frequencies, and the
+ * defaults afterwards draw exactly what they did before. Returns whether all of that held */
+static int CheckSampling(void)
+{
+    static const short settings[][2] = {{MARKOV_DEFAULT_TEMPERATURE, MARKOV_DEFAULT_TOP_K},
+                                        {100, 1},
+                                        {25, 0},
+                                        {MARKOV_DEFAULT_TEMPERATURE, MARKOV_DEFAULT_TOP_K}};
+    WordID recentWords[MARKOV_ORDER], top;
+    short recentCount = 0, distinct[4], logProb, state;
+    long hits[4];
+    int i, passed;
+
+    PushWord(recentWords, &recentCount, kSentenceStart);
+    state = MarkovChain_FindContext(gChain, recentWords, recentCount);
+    if (state < 0 || MarkovChain_LikelyFollowers(gChain, state, 1, &top, &logProb) == 0) {
+        printf("\nsampling check: FAILED, no sentence starts\n");
+        return 0;
+    }
+
+    for (i = 0; i < 4; i++) {
+        MarkovChain_SetSampling(gChain, settings[i][0], settings[i][1]);
+        Random_Seed(&gRandom, gSeed, kRandomStreamBench);
+        hits[i] = DrawFollowers(state, top, &distinct[i]);
+    }
+
+    passed = distinct[0] > 1 && hits[1] == kCheckDraws && distinct[1] == 1 && hits[2] > hits[0] &&
+             hits[3] == hits[0] && distinct[3] == distinct[0];
+    printf("\nsampling check: most likely start drawn %ld of %d times (%d distinct), %ld with "
+           "top-k 1, %ld at 25%% temperature, %ld back at the defaults: %s\n",
+           hits[0], kCheckDraws, distinct[0], hits[1], hits[2], hits[3],
+           passed ? "passed" : "FAILED");
+    return passed;
+}
+
+/* Check that beam decoded replies to one prompt differ. Each is a single candidate, so only the
+ * decoding can make them differ, and only the first sentences are compared, as replies also
+ * differ in how many sentences they have. Returns whether enough of them did */
+static int CheckBeamVariety(void)
+{
+    static char sentences[kCheckReplies][kMarkovReplyLength];
+    static TokenList prompt;
+    MarkovMixture mixture;
+    const char *reply;
+    size_t length;
+    int distinct = 0, i, j;
+
+    MarkovMixture_Init(&mixture);
+    MarkovMixture_Add(&mixture, gChain, 100);
+    Tokenizer_Split(&prompt, kPrompts[0]);
+    Random_Seed(&gRandom, gSeed, kRandomStreamBench);
+
+    for (i = 0; i < kCheckReplies; i++) {
+        ReplyBudget_Start();
+        reply = MarkovReply_Generate(&mixture, &prompt, 1, kCheckBeamWidth, &gRandom);
+        ReplyBudget_Finish();
+
+        length = strcspn(reply, ".!?");
+        memcpy(sentences[i], reply, length);
+        sentences[i][length] = '\0';
+        for (j = 0; j < i && strcmp(sentences[j], sentences[i]) != 0; j++)
+            ;
+        if (j == i)
+            distinct++;
+    }
+
+    printf("beam check: %d distinct first sentences in %d replies to \"%s\" at width %d: %s\n",
+           distinct, kCheckReplies, kPrompts[0], kCheckBeamWidth,
+           (distinct > kCheckReplies / 4) ? "passed" : "FAILED");
+    return distinct > kCheckReplies / 4;
+}
+
+int main(int argc, char **argv)
+{
+    static char buffer[kMaxOutput];
+    long length, words;
+    int passed;
+    int method, i;
+    clock_t start;
+    double seconds;
+
+    for (i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "-s") == 0 && i + 1 < argc) {
+            gSeed = strtoul(argv[++i], NULL, 10);
+        }
+        else {
+            fprintf(stderr, "usage: %s [-s seed]\n", argv[0]);
+            return 1;
+        }
+    }
+
+    gChain = malloc(MarkovChain_StorageSize(MAX_NODES));
+    if (gChain == NULL)
+        return 1;
+    MarkovChain_Init(gChain, MAX_NODES);
+    LoadStaticTrainingData();
+    memset(&gChain->lookupStats, 0, sizeof(gChain->lookupStats)); /* Count generation only */
+
+    printf("%8s %8s %14s %14s\n", "chars", "words", "strcat ns/wd", "builder ns/wd");
+    for (length = 512; length <= kMaxOutput; length *= 2) {
+        printf("%8ld", length);
+        for (method = 0; method < 2; method++) {
+            start = clock();
+            for (i = 0; i < kRepeats; i++) {
+                words = Walk(buffer, length, method);
+            }
+            seconds = (double)(clock() - start) / CLOCKS_PER_SEC;
+
+            if (method == 0)
+                printf(" %8ld", words);
+            printf(" %14.1f", seconds * 1e9 / ((double)words * kRepeats));
+        }
+        printf("\n");
+    }
+
+    BenchCandidates();
+    BenchBeam();
+    PrintLookups();
+    printf("\nseed %lu, reply checksum %08lX\n", gSeed, gReplyChecksum);
+
+    passed = CheckSampling();
+    passed = CheckBeamVariety() && passed;
+    return passed ? 0 : 1;
+}
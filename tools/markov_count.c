@@ -0,0 +1,589 @@
+#include <stdlib.h>
+#include <string.h>
+
+#include "markov_count.h"
+
+#define kNoCountWord 0xFFFFFFFFUL
+#define kFirstWordSlots 4096 /* Both tables start with this many slots and double when half full */
+
+/* Scaled counts of a context add up to at most this, before those under one are rounded up */
+#define kRoundedTotal (kMaxFollowerTotal - MAX_FOLLOWERS)
+
+/* Words are numbered in the order a table first saw them, so the sentence markers come first */
+#define kCountStart 0
+#define kCountEnd 1
+
+/* How often a word followed a context. Unused context words are kNoCountWord, so a context of
+ * fewer words sorts after the longer ones it starts */
+typedef struct {
+    uint32_t words[MARKOV_ORDER + 1]; /* The context newest first, then the follower */
+    uint64_t count;                   /* 0 for an empty slot */
+} CountPair;
+
+struct CountTable {
+    char *text; /* Every word, each ending in a null character */
+    size_t textUsed, textSize;
+    size_t *wordOffsets; /* Of each word in the text */
+    uint32_t wordCount, wordsSize;
+    uint32_t *wordSlots; /* Open addressed word numbers, kNoCountWord where empty */
+    uint32_t wordSlotCount;
+    CountPair *pairs; /* Open addressed */
+    size_t pairCount, pairSlotCount;
+};
+
+/* A context while filling a chain: its pairs are sorted together, most frequent first */
+typedef struct {
+    size_t first;
+    size_t followers;
+    uint64_t scale; /* Its counts are divided by this */
+    short order;
+} FillContext;
+
+/* A pair to fill a chain with, and its context */
+typedef struct {
+    size_t pair;
+    size_t context;
+    uint64_t rank; /* How far down its order it is, as a fraction of 2^32 */
+    short order;
+} FillPair;
+
+/* What the comparisons for qsort look into, which it has no way to pass */
+static const CountTable *gSortTable;
+static const CountPair *gSortPairs;
+
+#define CountWord(table, id) ((table)->text + (table)->wordOffsets[id])
+
+/* FNV-1a hash of a word */
+static uint32_t HashText(const char *text, size_t length)
+{
+    uint32_t hash = 2166136261UL;
+    size_t i;
+
+    for (i = 0; i < length; i++) {
+        hash = (hash ^ (unsigned char)text[i]) * 16777619UL;
+    }
+    return hash;
+}
+
+/* Hash of a pair's words */
+static size_t HashPair(const uint32_t *words)
+{
+    uint64_t hash = 14695981039346656037ULL;
+    short i;
+
+    for (i = 0; i <= MARKOV_ORDER; i++) {
+        hash = (hash ^ words[i]) * 1099511628211ULL;
+    }
+    return (size_t)(hash ^ (hash >> 32));
+}
+
+/* Find the slot of a word, or the empty slot where it belongs */
+static uint32_t FindWordSlot(const CountTable *table, const char *text, size_t length)
+{
+    uint32_t mask = table->wordSlotCount - 1;
+    uint32_t slot = HashText(text, length) & mask;
+    uint32_t id;
+
+    while ((id = table->wordSlots[slot]) != kNoCountWord &&
+           (strncmp(CountWord(table, id), text, length) != 0 ||
+            CountWord(table, id)[length] != '\0')) {
+        slot = (slot + 1) & mask;
+    }
+    return slot;
+}
+
+/* Double the word slots, returns FALSE if out of memory */
+static Boolean GrowWordSlots(CountTable *table)
+{
+    uint32_t *old     = table->wordSlots;
+    uint32_t oldCount = table->wordSlotCount;
+    uint32_t i;
+    const char *text;
+
+    table->wordSlots = malloc(2 * oldCount * sizeof(uint32_t));
+    if (table->wordSlots == NULL) {
+        table->wordSlots = old;
+        return FALSE;
+    }
+    table->wordSlotCount = 2 * oldCount;
+    memset(table->wordSlots, 0xFF, table->wordSlotCount * sizeof(uint32_t));
+
+    for (i = 0; i < oldCount; i++) {
+        if (old[i] == kNoCountWord)
+            continue;
+        text = CountWord(table, old[i]);
+        table->wordSlots[FindWordSlot(table, text, strlen(text))] = old[i];
+    }
+    free(old);
+    return TRUE;
+}
+
+/* Number a word of length characters, adding it if it is new; kNoCountWord if out of memory */
+static uint32_t InternCountWord(CountTable *table, const char *text, size_t length)
+{
+    uint32_t slot = FindWordSlot(table, text, length);
+    size_t newSize;
+    void *grown;
+
+    if (table->wordSlots[slot] != kNoCountWord)
+        return table->wordSlots[slot];
+
+    if (table->textUsed + length + 1 > table->textSize) {
+        newSize = 2 * table->textSize + length + 1;
+        grown   = realloc(table->text, newSize);
+        if (grown == NULL)
+            return kNoCountWord;
+        table->text     = grown;
+        table->textSize = newSize;
+    }
+    if (table->wordCount == table->wordsSize) {
+        grown = realloc(table->wordOffsets, 2 * table->wordsSize * sizeof(size_t));
+        if (grown == NULL)
+            return kNoCountWord;
+        table->wordOffsets = grown;
+        table->wordsSize *= 2;
+    }
+
+    memcpy(table->text + table->textUsed, text, length);
+    table->text[table->textUsed + length] = '\0';
+    table->wordOffsets[table->wordCount]  = table->textUsed;
+    table->wordSlots[slot]                = table->wordCount;
+    table->textUsed += length + 1;
+
+    if (2 * ++table->wordCount > table->wordSlotCount && !GrowWordSlots(table))
+        return kNoCountWord;
+    return table->wordCount - 1;
+}
+
+/* Find the slot of a pair, or the empty slot where it belongs */
+static size_t FindPairSlot(const CountPair *pairs, size_t slotCount, const uint32_t *words)
+{
+    size_t mask = slotCount - 1;
+    size_t slot = HashPair(words) & mask;
+
+    while (pairs[slot].count != 0 && memcmp(pairs[slot].words, words, sizeof(pairs->words)) != 0) {
+        slot = (slot + 1) & mask;
+    }
+    return slot;
+}
+
+/* Double the pair slots, returns FALSE if out of memory */
+static Boolean GrowPairSlots(CountTable *table)
+{
+    CountPair *old  = table->pairs;
+    size_t oldCount = table->pairSlotCount;
+    size_t newCount = 2 * oldCount;
+    size_t i;
+
+    table->pairs = calloc(newCount, sizeof(CountPair));
+    if (table->pairs == NULL) {
+        table->pairs = old;
+        return FALSE;
+    }
+    table->pairSlotCount = newCount;
+
+    for (i = 0; i < oldCount; i++) {
+        if (old[i].count != 0)
+            table->pairs[FindPairSlot(table->pairs, newCount, old[i].words)] = old[i];
+    }
+    free(old);
+    return TRUE;
+}
+
+/* Add to the count of a pair, returns FALSE if out of memory */
+static Boolean AddPair(CountTable *table, const uint32_t *words, uint64_t count)
+{
+    CountPair *pair = &table->pairs[FindPairSlot(table->pairs, table->pairSlotCount, words)];
+
+    if (pair->count != 0) {
+        pair->count += count;
+        return TRUE;
+    }
+
+    memcpy(pair->words, words, sizeof(pair->words));
+    pair->count = count;
+    if (2 * ++table->pairCount > table->pairSlotCount)
+        return GrowPairSlots(table);
+    return TRUE;
+}
+
+/* Make an empty table, NULL if out of memory */
+CountTable *CountTable_New(void)
+{
+    CountTable *table = calloc(1, sizeof(CountTable));
+
+    if (table == NULL)
+        return NULL;
+
+    table->textSize      = 16 * kFirstWordSlots;
+    table->wordsSize     = kFirstWordSlots;
+    table->wordSlotCount = kFirstWordSlots;
+    table->pairSlotCount = kFirstWordSlots;
+    table->text          = malloc(table->textSize);
+    table->wordOffsets   = malloc(table->wordsSize * sizeof(size_t));
+    table->wordSlots     = malloc(table->wordSlotCount * sizeof(uint32_t));
+    table->pairs         = calloc(table->pairSlotCount, sizeof(CountPair));
+    if (table->text == NULL || table->wordOffsets == NULL || table->wordSlots == NULL ||
+        table->pairs == NULL) {
+        CountTable_Free(table);
+        return NULL;
+    }
+    memset(table->wordSlots, 0xFF, table->wordSlotCount * sizeof(uint32_t));
+
+    /* The markers are counted as words, by the text the chain gives them */
+    InternCountWord(table, kSentenceStartText, strlen(kSentenceStartText));
+    InternCountWord(table, kSentenceEndText, strlen(kSentenceEndText));
+    return table;
+}
+
+void CountTable_Free(CountTable *table)
+{
+    if (table == NULL)
+        return;
+    free(table->text);
+    free(table->wordOffsets);
+    free(table->wordSlots);
+    free(table->pairs);
+    free(table);
+}
+
+/* Count a word as a follower of every context order ending at the newest recent word */
+static Boolean CountFollower(CountTable *table, const CountWalk *walk, uint32_t word)
+{
+    uint32_t words[MARKOV_ORDER + 1];
+    short order;
+
+    for (order = 0; order < MARKOV_ORDER; order++) {
+        words[order] = kNoCountWord;
+    }
+    words[MARKOV_ORDER] = word;
+
+    for (order = 1; order <= walk->recentCount; order++) {
+        words[order - 1] = walk->recentWords[order - 1];
+        if (!AddPair(table, words, 1))
+            return FALSE;
+    }
+    return TRUE;
+}
+
+/* Make a word the newest of the recent words */
+static void PushCountWord(CountWalk *walk, uint32_t word)
+{
+    short i;
+
+    for (i = (walk->recentCount < MARKOV_ORDER) ? walk->recentCount : MARKOV_ORDER - 1; i > 0;
+         i--) {
+        walk->recentWords[i] = walk->recentWords[i - 1];
+    }
+    walk->recentWords[0] = word;
+    if (walk->recentCount < MARKOV_ORDER)
+        walk->recentCount++;
+}
+
+/* Start a sentence from the start marker alone */
+static void StartCountSentence(CountWalk *walk)
+{
+    walk->recentCount   = 0;
+    walk->sentenceWords = 0;
+    PushCountWord(walk, kCountStart);
+}
+
+/* Start a walk at the start of a sentence */
+void CountTable_BeginWalk(CountTable *table, CountWalk *walk)
+{
+    (void)table;
+    StartCountSentence(walk);
+}
+
+/* Walk on through a list of tokens, counting as MarkovChain_Train does */
+Boolean CountTable_Walk(CountTable *table, CountWalk *walk, const TokenList *tokens)
+{
+    const Token *token;
+    const char *text;
+    short length, i;
+    uint32_t word;
+    Boolean endsSentence;
+
+    for (i = 0; i < tokens->count; i++) {
+        token  = &tokens->tokens[i];
+        text   = Tokenizer_Word(tokens, token);
+        length = MarkovChain_CleanWordLength(text, token->length, &endsSentence);
+        if (length == 0)
+            continue;
+
+        word = InternCountWord(table, text, length);
+        if (word == kNoCountWord || !CountFollower(table, walk, word))
+            return FALSE;
+        PushCountWord(walk, word);
+        walk->sentenceWords++;
+
+        if (endsSentence) {
+            if (!CountFollower(table, walk, kCountEnd))
+                return FALSE;
+            StartCountSentence(walk);
+        }
+    }
+    return TRUE;
+}
+
+/* Finish a walk; text that stops without punctuation still ends its sentence */
+Boolean CountTable_EndWalk(CountTable *table, CountWalk *walk)
+{
+    return walk->sentenceWords == 0 || CountFollower(table, walk, kCountEnd);
+}
+
+/* Add the counts of one table to another */
+Boolean CountTable_Merge(CountTable *into, const CountTable *from)
+{
+    uint32_t words[MARKOV_ORDER + 1];
+    uint32_t *map;
+    const char *text;
+    size_t i;
+    short j;
+
+    /* The tables number words differently, so each is looked up by its text */
+    map = malloc(from->wordCount * sizeof(uint32_t));
+    if (map == NULL)
+        return FALSE;
+    for (i = 0; i < from->wordCount; i++) {
+        text   = CountWord(from, i);
+        map[i] = InternCountWord(into, text, strlen(text));
+        if (map[i] == kNoCountWord) {
+            free(map);
+            return FALSE;
+        }
+    }
+
+    for (i = 0; i < from->pairSlotCount; i++) {
+        if (from->pairs[i].count == 0)
+            continue;
+        for (j = 0; j <= MARKOV_ORDER; j++) {
+            words[j] = (from->pairs[i].words[j] == kNoCountWord) ? kNoCountWord
+                                                                 : map[from->pairs[i].words[j]];
+        }
+        if (!AddPair(into, words, from->pairs[i].count)) {
+            free(map);
+            return FALSE;
+        }
+    }
+
+    free(map);
+    return TRUE;
+}
+
+long CountTable_WordCount(const CountTable *table)
+{
+    return table->wordCount;
+}
+
+long CountTable_PairCount(const CountTable *table)
+{
+    return table->pairCount;
+}
+
+/* Order words by their text */
+static int CompareWordText(const void *a, const void *b)
+{
+    return strcmp(CountWord(gSortTable, *(const uint32_t *)a),
+                  CountWord(gSortTable, *(const uint32_t *)b));
+}
+
+/* Order pairs by context, then most frequent follower first */
+static int ComparePairs(const void *a, const void *b)
+{
+    const CountPair *pairA = a;
+    const CountPair *pairB = b;
+    short i;
+
+    for (i = 0; i < MARKOV_ORDER; i++) {
+        if (pairA->words[i] != pairB->words[i])
+            return (pairA->words[i] < pairB->words[i]) ? -1 : 1;
+    }
+    if (pairA->count != pairB->count)
+        return (pairA->count > pairB->count) ? -1 : 1;
+    return (pairA->words[MARKOV_ORDER] < pairB->words[MARKOV_ORDER]) ? -1 : 1;
+}
+
+/* Order the pairs to fill a chain with by order, then by count, most frequent first */
+static int CompareOrderPairs(const void *a, const void *b)
+{
+    const FillPair *fillA  = a;
+    const FillPair *fillB  = b;
+    const CountPair *pairA = &gSortPairs[fillA->pair];
+    const CountPair *pairB = &gSortPairs[fillB->pair];
+
+    if (fillA->order != fillB->order)
+        return (fillA->order < fillB->order) ? -1 : 1;
+    if (pairA->count != pairB->count)
+        return (pairA->count > pairB->count) ? -1 : 1;
+    return ComparePairs(pairA, pairB);
+}
+
+/* Order the pairs to fill a chain with by how far down their order they rank, shortest
+ * contexts first on ties */
+static int CompareFillPairs(const void *a, const void *b)
+{
+    const FillPair *fillA = a;
+    const FillPair *fillB = b;
+
+    if (fillA->rank != fillB->rank)
+        return (fillA->rank < fillB->rank) ? -1 : 1;
+    if (fillA->order != fillB->order)
+        return (fillA->order < fillB->order) ? -1 : 1;
+    return ComparePairs(&gSortPairs[fillA->pair], &gSortPairs[fillB->pair]);
+}
+
+/* Scale for the counts of a context's followers, most frequent first, so they fit the chain's
+ * limits. Rounding a count of less than one up to one adds at most one per follower, so the
+ * total is scaled to leave room for that */
+static uint64_t FollowerScale(const CountPair *pairs, size_t count)
+{
+    uint64_t total = 0;
+    uint64_t scale, countScale;
+    size_t i;
+
+    for (i = 0; i < count; i++) {
+        total += pairs[i].count;
+    }
+    scale      = (total + kRoundedTotal - 1) / kRoundedTotal;
+    countScale = (pairs[0].count + kMaxFollowerCount - 1) / kMaxFollowerCount;
+    if (countScale > scale)
+        scale = countScale;
+    return (scale > 0) ? scale : 1;
+}
+
+/* Check whether a full chain already has a context, so it can take more followers */
+static Boolean HasContext(MarkovChain *chain, const char *const *words, short order)
+{
+    WordID word;
+    short node = -1;
+    short i;
+
+    for (i = 0; i < order; i++) {
+        word = MarkovChain_FindWord(chain, words[i]);
+        if (word == kNoWord || (node = MarkovChain_FindState(chain, node, word)) < 0)
+            return FALSE;
+    }
+    return TRUE;
+}
+
+/* Add the counts to an empty chain, most frequent first until the chain is full */
+Boolean CountTable_Fill(const CountTable *table, MarkovChain *chain)
+{
+    const char *words[MARKOV_ORDER];
+    uint32_t *byRank, *ranks;
+    CountPair *pairs;
+    FillContext *contexts;
+    FillPair *fills;
+    size_t pairCount    = 0;
+    size_t contextCount = 0;
+    size_t fillCount    = 0;
+    const CountPair *pair;
+    const FillContext *context;
+    uint64_t count;
+    size_t i, k, first;
+    short j;
+
+    byRank   = malloc(table->wordCount * sizeof(uint32_t));
+    ranks    = malloc(table->wordCount * sizeof(uint32_t));
+    pairs    = malloc((table->pairCount + 1) * sizeof(CountPair));
+    contexts = malloc((table->pairCount + 1) * sizeof(FillContext));
+    fills    = malloc((table->pairCount + 1) * sizeof(FillPair));
+    if (byRank == NULL || ranks == NULL || pairs == NULL || contexts == NULL || fills == NULL) {
+        free(byRank);
+        free(ranks);
+        free(pairs);
+        free(contexts);
+        free(fills);
+        return FALSE;
+    }
+
+    /* Words are renumbered by their text, so the sort is the same whatever order the counts
+     * came in */
+    for (i = 0; i < table->wordCount; i++) {
+        byRank[i] = i;
+    }
+    gSortTable = table;
+    qsort(byRank, table->wordCount, sizeof(uint32_t), CompareWordText);
+    for (i = 0; i < table->wordCount; i++) {
+        ranks[byRank[i]] = i;
+    }
+
+    for (i = 0; i < table->pairSlotCount; i++) {
+        if (table->pairs[i].count == 0)
+            continue;
+        pairs[pairCount] = table->pairs[i];
+        for (j = 0; j <= MARKOV_ORDER; j++) {
+            if (pairs[pairCount].words[j] != kNoCountWord)
+                pairs[pairCount].words[j] = ranks[pairs[pairCount].words[j]];
+        }
+        pairCount++;
+    }
+    qsort(pairs, pairCount, sizeof(CountPair), ComparePairs);
+
+    /* Pairs of one context are now together */
+    for (i = 0; i < pairCount; i++) {
+        if (i == 0 ||
+            memcmp(pairs[i].words, pairs[i - 1].words, MARKOV_ORDER * sizeof(uint32_t)) != 0) {
+            contexts[contextCount].first     = i;
+            contexts[contextCount].followers = 0;
+            for (j = 0; j < MARKOV_ORDER && pairs[i].words[j] != kNoCountWord; j++)
+                ;
+            contexts[contextCount++].order = j;
+        }
+        contexts[contextCount - 1].followers++;
+    }
+    /* A context keeps its most frequent followers, each a pair to fill */
+    for (i = 0; i < contextCount; i++) {
+        count = (contexts[i].followers < MAX_FOLLOWERS) ? contexts[i].followers : MAX_FOLLOWERS;
+        contexts[i].scale = FollowerScale(&pairs[contexts[i].first], count);
+        for (k = 0; k < count; k++) {
+            fills[fillCount].pair    = contexts[i].first + k;
+            fills[fillCount].context = i;
+            fills[fillCount].order   = contexts[i].order;
+            fillCount++;
+        }
+    }
+    /* Pairs go in most frequent first, so the chain's words go to the pairs that need them
+     * most. Counts of different orders don't compare, since a shorter context is at least as
+     * frequent as every longer one ending in it; ranked by count alone, the shortest would take
+     * the whole chain. So each order is ranked on its own and they take turns, each as far down
+     * its ranking as the others, and a full chain holds the same share of every order */
+    gSortPairs = pairs;
+    qsort(fills, fillCount, sizeof(FillPair), CompareOrderPairs);
+    for (first = 0; first < fillCount; first = k) {
+        for (k = first; k < fillCount && fills[k].order == fills[first].order; k++)
+            ;
+        for (i = first; i < k; i++) {
+            fills[i].rank = ((uint64_t)(i - first) << 32) / (k - first);
+        }
+    }
+    qsort(fills, fillCount, sizeof(FillPair), CompareFillPairs);
+
+    for (i = 0; i < fillCount; i++) {
+        pair    = &pairs[fills[i].pair];
+        context = &contexts[fills[i].context];
+        for (j = 0; j < context->order; j++) {
+            words[j] = CountWord(table, byRank[pair->words[j]]);
+        }
+
+        /* Once the chain or its follower pool is full only the contexts in it can take
+         * followers; a new context would get no room for any */
+        if ((chain->nodeCount == chain->maxNodes || chain->followerPoolSaturated) &&
+            !HasContext(chain, words, context->order))
+            continue;
+        count = pair->count / context->scale;
+        MarkovChain_AddCount(chain, words, context->order,
+                             CountWord(table, byRank[pair->words[MARKOV_ORDER]]),
+                             (unsigned short)((count > 0) ? count : 1));
+    }
+    /* The context whose follower filled the pool is left with none */
+    MarkovChain_Prune(chain, 1, chain->order);
+
+    free(byRank);
+    free(ranks);
+    free(pairs);
+    free(contexts);
+    free(fills);
+    return TRUE;
+}
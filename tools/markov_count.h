@@ -0,0 +1,50 @@
+#ifndef MARKOV_COUNT_H
+#define MARKOV_COUNT_H
+
+/* Transition counts for building a Markov model from a large corpus on the host
+ *
+ * A count table counts every (context, follower) pair of some training text exactly, at every
+ * context order, the way MarkovChain_Train would but with no limit on words, contexts or counts.
+ * Tables filled from separate parts of a corpus add up with CountTable_Merge, so the parts can
+ * be counted in parallel. CountTable_Fill then builds a chain of limited capacity from the total,
+ * keeping the most frequent contexts of each order and their followers. Nothing depends on the
+ * order the parts were counted or merged in, so the chain comes out the same however the corpus
+ * was split.
+ */
+#include <stdint.h>
+
+#include "markov_chain.h"
+
+typedef struct CountTable CountTable;
+
+/* A walk through training text a sentence at a time; it may come a token list at a time */
+typedef struct {
+    uint32_t recentWords[MARKOV_ORDER]; /* Newest first */
+    short recentCount;
+    long sentenceWords; /* Words seen so far in the current sentence */
+} CountWalk;
+
+/* Make an empty table, NULL if out of memory */
+CountTable *CountTable_New(void);
+void CountTable_Free(CountTable *table);
+
+/* Count training text. A walk starts at the start of a sentence; ending it ends any sentence left
+ * unfinished, as the end of a training text does. Counting returns FALSE if out of memory */
+void CountTable_BeginWalk(CountTable *table, CountWalk *walk);
+Boolean CountTable_Walk(CountTable *table, CountWalk *walk, const TokenList *tokens);
+Boolean CountTable_EndWalk(CountTable *table, CountWalk *walk);
+
+/* Add the counts of one table to another, returns FALSE if out of memory */
+Boolean CountTable_Merge(CountTable *into, const CountTable *from);
+
+/* Distinct words and (context, follower) pairs counted */
+long CountTable_WordCount(const CountTable *table);
+long CountTable_PairCount(const CountTable *table);
+
+/* Add the counts to an empty chain, the most frequent pairs of each context order in turn, until
+ * it has no room for more words, contexts or followers. A context keeps its MAX_FOLLOWERS most
+ * frequent followers, with counts scaled down to the chain's limits. Returns FALSE if out of
+ * memory */
+Boolean CountTable_Fill(const CountTable *table, MarkovChain *chain);
+
+#endif /* MARKOV_COUNT_H */
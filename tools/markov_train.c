@@ -0,0 +1,841 @@
+/* Host-side Markov model compiler
+ *
+ * Trains the static corpus from src/chatbot/markov_data.c with the same chain core the app
+ * uses and writes the result in the compact model format. With -r the output is Rez source
+ * that src/main.r includes, so the app can load the model in one read instead of training.
+ * With -b the model is pruned of its rarest transitions until it fits the given size. With -t
+ * each topic of the corpus also gets a sub-model sharing the general model's dictionary, which
+ * the app mixes in for prompts about that topic; these follow the general model in the Rez
+ * source, at MARKOV_MODEL_RES_ID + topic. It fails if the dictionary has no room for some word
+ * of the corpus, so the build does too rather than ship a model with gaps in it.
+ *
+ * Models are trained in the largest chain there is. Then the least trained contexts, longest
+ * first, and the rarest followers are forgotten until a chain of the app's MAX_NODES has room
+ * for the rest. What the app can't hold is left out on purpose, rather than wherever the chain
+ * happened to fill up. The contexts even the largest chain had no room for are counted and
+ * warned about.
+ *
+ * Given text files, or - for standard input, it trains on those instead of the static corpus.
+ * Files of any size are streamed through one read buffer, and the throughput, peak memory use
+ * and the words and contexts there was no room for are reported so regressions show up. Any
+ * such words fail it here too, before it writes anything. With -j the files are instead cut into
+ * shards at sentence ends, which a pool of threads counts into tables of their own. The tables
+ * are merged and the model filled from the total, which comes out the same for any number of
+ * threads.
+ *
+ * That is a different model from the one trained without -j. Streaming learns as the app learns
+ * its corpus, in the chain's own bounded memory and without evicting anything. Once the chain is
+ * full the contexts it has still learn followers, but new ones are refused and counted, so early
+ * text decides which contexts there are; only then is the model fitted to MAX_NODES. Counting
+ * keeps the most frequent contexts of each order, their followers and words of the whole corpus
+ * instead, but its tables grow with the distinct word pairs, once per thread until the merge:
+ * tens of megabytes for a corpus that streams in 4. Extra threads only pay off with as many cores
+ * and a corpus large enough to outweigh the merge.
+ *
+ * With -s it also prints how full each model is and how its contents are shaped: contexts by
+ * order and by follower count, saturated contexts and counts, fill of the follower pool and
+ * dictionary, memory and state lookup probes. These are what to size the chain's capacity by.
+ */
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/resource.h>
+#include <time.h>
+
+#include "markov_chain.h"
+#include "markov_count.h"
+#include "markov_data.h"
+
+/* Text read from a corpus file at a time. Each read is trained up to its last sentence end, and
+ * the rest carried over to the next, so a buffer only splits sentences longer than itself */
+#define kReadBufferSize 65536
+
+/* Models are trained with room for as many contexts as any chain can have */
+#define kTrainingNodes kMarkovMaxNodes
+
+#define kMaxThreads 64
+#define kShardsPerThread 4        /* More shards than threads, so no thread is left waiting long */
+#define kMinShardSize (1L << 20) /* Smaller files get fewer shards */
+
+/* A byte range of a corpus file, starting at the start of a sentence. Standard input can't be
+ * split, so it is one shard read to its end */
+typedef struct {
+    const char *path;
+    long start, end;
+} Shard;
+
+/* A thread counting shards into a table of its own */
+typedef struct {
+    pthread_t thread;
+    CountTable *table;
+    char *buffer;
+    long bytes; /* Read from all its shards, -1 on error */
+} Worker;
+
+/* Shards waiting for a thread */
+static Shard *gShards;
+static int gShardCount;
+static int gNextShard;
+static pthread_mutex_t gShardLock = PTHREAD_MUTEX_INITIALIZER;
+
+/* The chains being built: the general model, trained on everything, and with -t the topic
+ * sub-models, sharing its dictionary. There is no sub-model for the general topic */
+static MarkovChain *gChains[kMarkovTopicCount];
+
+/* Corpus files call this for every training sentence */
+void TrainMarkov(const char *text)
+{
+    MarkovChain_Train(gChains[kMarkovTopicGeneral], text);
+}
+
+/* Print command line usage */
+static void Usage(const char *program)
+{
+    fprintf(stderr, "usage: %s [-r [-t]] [-b bytes] [-j threads] [-s] -o output [corpus ...]\n",
+            program);
+    fprintf(stderr, "  -r         write Rez source instead of the raw model\n");
+    fprintf(stderr, "  -t         add a sub-model for each topic, with -r and no corpus\n");
+    fprintf(stderr, "  -b bytes   prune the models until they fit in this many bytes\n");
+    fprintf(stderr, "  -j threads count the corpus files in shards on this many threads\n");
+    fprintf(stderr, "             and keep the most frequent text, not the first;\n");
+    fprintf(stderr, "             a different model, in memory that grows with the corpus\n");
+    fprintf(stderr, "  -s         print how full the models are and their shape\n");
+    fprintf(stderr, "  -o output  file to write\n");
+    fprintf(stderr, "  corpus     text files to train instead of the static corpus, - for stdin\n");
+}
+
+/* Seconds since some fixed point, for timing */
+static double Now(void)
+{
+    struct timespec now;
+
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return now.tv_sec + now.tv_nsec / 1e9;
+}
+
+/* Most memory the process has held, in kilobytes */
+static long PeakMemoryKB(void)
+{
+    struct rusage usage;
+
+    if (getrusage(RUSAGE_SELF, &usage) != 0)
+        return -1;
+#ifdef __APPLE__
+    return usage.ru_maxrss / 1024; /* Bytes on macOS */
+#else
+    return usage.ru_maxrss;
+#endif
+}
+
+/* Where to split a full read buffer: after the last sentence end, or failing that the last
+ * space, or failing that nowhere, as it is all one word */
+static size_t TrainingCut(const char *buffer, size_t length)
+{
+    size_t i, space = 0;
+
+    for (i = length - 1; i > 0; i--) {
+        if (Tokenizer_Is(buffer[i], kCharSpace)) {
+            if (Tokenizer_Is(buffer[i - 1], kCharEnder))
+                return i + 1;
+            if (space == 0)
+                space = i + 1;
+        }
+    }
+    return (space > 0) ? space : length;
+}
+
+/* Train a chain on a corpus file a buffer at a time. Training stops only at sentence ends, so
+ * this trains what one call with the whole file would. Returns the bytes read, -1 on error */
+static long TrainFile(MarkovChain *chain, const char *path)
+{
+    static char buffer[kReadBufferSize + 1];
+    size_t held = 0; /* Characters carried over from the last read */
+    long total  = 0;
+    size_t got, cut, i;
+    FILE *in;
+    char saved;
+
+    in = (strcmp(path, "-") == 0) ? stdin : fopen(path, "rb");
+    if (in == NULL) {
+        perror(path);
+        return -1;
+    }
+
+    do {
+        /* Reads come up short only at the end of the file */
+        got = fread(buffer + held, 1, kReadBufferSize - held, in);
+        total += got;
+
+        /* Training stops at a null character, so they are taken as spaces */
+        for (i = held; i < held + got; i++) {
+            if (buffer[i] == '\0')
+                buffer[i] = ' ';
+        }
+        held += got;
+
+        cut = (held == kReadBufferSize) ? TrainingCut(buffer, held) : held;
+        saved       = buffer[cut];
+        buffer[cut] = '\0';
+        MarkovChain_Train(chain, buffer);
+        buffer[cut] = saved;
+
+        memmove(buffer, buffer + cut, held - cut);
+        held -= cut;
+    } while (got > 0);
+
+    if (ferror(in)) {
+        perror(path);
+        total = -1;
+    }
+    if (in != stdin)
+        fclose(in);
+    return total;
+}
+
+/* Where a shard that nominally starts at offset really starts: after the first word from there
+ * on that ends a sentence, or at the end of the file. The word just before offset may have been
+ * cut, so it only counts once a space shows where it began */
+static long ShardStart(FILE *in, long offset, long size)
+{
+    char word[kMaxTokenLength];
+    long length     = 0;    /* Of the word so far, which is cut short as the tokenizer does */
+    Boolean partial = TRUE; /* Until a space shows where a word starts */
+    Boolean endsSentence;
+    long position;
+    int c;
+
+    if (offset <= 0)
+        return 0;
+    if (offset >= size || fseek(in, offset - 1, SEEK_SET) != 0)
+        return size;
+
+    for (position = offset - 1; position < size && (c = getc(in)) != EOF; position++) {
+        if (c != '\0' && !Tokenizer_Is(c, kCharSpace)) {
+            if (length < kMaxTokenLength)
+                word[length] = (char)c;
+            length++;
+            continue;
+        }
+
+        /* Nulls are read as spaces, as when training */
+        if (!partial && length > 0 &&
+            MarkovChain_CleanWordLength(word, (length < kMaxTokenLength) ? length : kMaxTokenLength,
+                                        &endsSentence) > 0 &&
+            endsSentence)
+            return position;
+        partial = FALSE;
+        length  = 0;
+    }
+    return size;
+}
+
+/* Cut each corpus file into shards, returns FALSE on error */
+static Boolean PlanShards(char **paths, int pathCount, int threads)
+{
+    long size, start, end;
+    int pieces, i, j;
+    FILE *in;
+
+    gShards = malloc(pathCount * threads * kShardsPerThread * sizeof(Shard));
+    if (gShards == NULL) {
+        fprintf(stderr, "markov_train: out of memory\n");
+        return FALSE;
+    }
+
+    for (i = 0; i < pathCount; i++) {
+        if (strcmp(paths[i], "-") == 0) {
+            gShards[gShardCount].path  = paths[i];
+            gShards[gShardCount].start = 0;
+            gShards[gShardCount].end   = -1;
+            gShardCount++;
+            continue;
+        }
+
+        in = fopen(paths[i], "rb");
+        if (in == NULL || fseek(in, 0, SEEK_END) != 0 || (size = ftell(in)) < 0) {
+            perror(paths[i]);
+            if (in != NULL)
+                fclose(in);
+            return FALSE;
+        }
+
+        pieces = threads * kShardsPerThread;
+        if (pieces > size / kMinShardSize + 1)
+            pieces = size / kMinShardSize + 1;
+
+        /* Each shard ends where the next starts, and empty ones are left out */
+        start = 0;
+        for (j = 1; j <= pieces; j++) {
+            end = (j == pieces) ? size : ShardStart(in, (long)((double)size * j / pieces), size);
+            if (end > start) {
+                gShards[gShardCount].path  = paths[i];
+                gShards[gShardCount].start = start;
+                gShards[gShardCount].end   = end;
+                gShardCount++;
+            }
+            start = end;
+        }
+        fclose(in);
+    }
+    return TRUE;
+}
+
+/* Count one shard a buffer at a time, returns the bytes read, -1 on error */
+static long CountShard(CountTable *table, char *buffer, const Shard *shard)
+{
+    TokenList tokens;
+    CountWalk walk;
+    size_t held = 0; /* Characters carried over from the last read */
+    long left   = shard->end - shard->start;
+    long total  = 0;
+    size_t want, got, cut, i;
+    const char *text;
+    Boolean counted = TRUE;
+    FILE *in;
+    char saved;
+
+    in = (shard->end < 0) ? stdin : fopen(shard->path, "rb");
+    if (in == NULL || (in != stdin && fseek(in, shard->start, SEEK_SET) != 0)) {
+        perror(shard->path);
+        if (in != NULL)
+            fclose(in);
+        return -1;
+    }
+
+    CountTable_BeginWalk(table, &walk);
+    do {
+        want = kReadBufferSize - held;
+        if (shard->end >= 0 && (long)want > left - total)
+            want = left - total;
+        got = fread(buffer + held, 1, want, in);
+        total += got;
+
+        for (i = held; i < held + got; i++) {
+            if (buffer[i] == '\0')
+                buffer[i] = ' ';
+        }
+        held += got;
+
+        /* The walk carries on from one read to the next, so any space will do to cut at */
+        cut         = (held == kReadBufferSize) ? TrainingCut(buffer, held) : held;
+        saved       = buffer[cut];
+        buffer[cut] = '\0';
+        for (text = buffer; *text != '\0' && counted;) {
+            text += Tokenizer_Split(&tokens, text);
+            counted = CountTable_Walk(table, &walk, &tokens);
+        }
+        buffer[cut] = saved;
+
+        memmove(buffer, buffer + cut, held - cut);
+        held -= cut;
+    } while (got > 0 && counted);
+
+    if (counted)
+        counted = CountTable_EndWalk(table, &walk);
+    if (!counted) {
+        fprintf(stderr, "markov_train: out of memory\n");
+        total = -1;
+    }
+    if (ferror(in)) {
+        perror(shard->path);
+        total = -1;
+    }
+    if (in != stdin)
+        fclose(in);
+    return total;
+}
+
+/* Count shards until none are left */
+static void *CountShards(void *argument)
+{
+    Worker *worker = argument;
+    long bytes;
+    int shard;
+
+    while (worker->bytes >= 0) {
+        pthread_mutex_lock(&gShardLock);
+        shard = (gNextShard < gShardCount) ? gNextShard++ : -1;
+        pthread_mutex_unlock(&gShardLock);
+        if (shard < 0)
+            break;
+
+        bytes         = CountShard(worker->table, worker->buffer, &gShards[shard]);
+        worker->bytes = (bytes >= 0) ? worker->bytes + bytes : -1;
+    }
+    return NULL;
+}
+
+/* Count corpus files on a pool of threads and fill a chain from the total. Returns the bytes
+ * counted, -1 on error. Whatever fails, every thread started is joined and everything freed */
+static long CountCorpus(MarkovChain *chain, char **paths, int pathCount, int threads)
+{
+    Worker workers[kMaxThreads];
+    long bytes = 0;
+    double started, counted, merged;
+    Boolean ok;
+    int running, i;
+
+    memset(workers, 0, sizeof(workers));
+    ok = PlanShards(paths, pathCount, threads);
+    for (i = 0; i < threads && ok; i++) {
+        workers[i].table  = CountTable_New();
+        workers[i].buffer = malloc(kReadBufferSize + 1);
+        if (workers[i].table == NULL || workers[i].buffer == NULL) {
+            fprintf(stderr, "markov_train: out of memory\n");
+            ok = FALSE;
+        }
+    }
+
+    started = Now();
+    for (running = 0; running < threads && ok; running++) {
+        if (pthread_create(&workers[running].thread, NULL, CountShards, &workers[running]) != 0) {
+            fprintf(stderr, "markov_train: couldn't start a thread\n");
+            ok = FALSE;
+            break;
+        }
+    }
+    if (!ok) {
+        /* The threads already running finish the shard they are on and stop */
+        pthread_mutex_lock(&gShardLock);
+        gNextShard = gShardCount;
+        pthread_mutex_unlock(&gShardLock);
+    }
+    for (i = 0; i < running; i++) {
+        pthread_join(workers[i].thread, NULL);
+        if (workers[i].bytes < 0)
+            ok = FALSE;
+        bytes += workers[i].bytes;
+    }
+    counted = Now();
+
+    /* Sums don't depend on which thread counted which shard. Each table is freed once merged,
+     * which keeps the peak down */
+    for (i = 1; i < threads && ok; i++) {
+        ok = CountTable_Merge(workers[0].table, workers[i].table);
+        CountTable_Free(workers[i].table);
+        workers[i].table = NULL;
+        if (!ok)
+            fprintf(stderr, "markov_train: out of memory\n");
+    }
+    merged = Now();
+    if (ok && !CountTable_Fill(workers[0].table, chain)) {
+        fprintf(stderr, "markov_train: out of memory\n");
+        ok = FALSE;
+    }
+
+    if (ok) {
+        printf("markov_train: %d shards on %d threads, counted in %.2f s (%.1f MB/s), merged %ld "
+               "words and %ld pairs in %.2f s, filled in %.2f s\n",
+               gShardCount, threads, counted - started,
+               (counted > started) ? bytes / (counted - started) / 1e6 : 0.0,
+               CountTable_WordCount(workers[0].table), CountTable_PairCount(workers[0].table),
+               merged - counted, Now() - merged);
+    }
+
+    for (i = 0; i < threads; i++) {
+        CountTable_Free(workers[i].table);
+        free(workers[i].buffer);
+    }
+    free(gShards);
+    gShards = NULL;
+    return ok ? bytes : -1;
+}
+
+/* Print the size of the chain */
+static void PrintStats(const char *stage, const MarkovChain *chain)
+{
+    MarkovChainStats stats;
+
+    MarkovChain_GetStats(chain, &stats);
+    printf("markov_train: %-8s %5d states, %4d words, %5ld followers, %5u pool entries, "
+           "%u prunes, %u halvings, %ld bytes\n",
+           stage, stats.nodeCount, stats.wordCount, stats.followers, stats.poolUsed,
+           stats.poolPrunes, stats.countHalvings, MarkovChain_SavedSize(chain));
+}
+
+/* Check that training found room for every word, returns FALSE if some were dropped. A model
+ * missing words has gaps wherever they came up, so it is no use building one. Contexts even the
+ * largest chain had no room for leave gaps too, but only a smaller corpus or a lower order can
+ * close them, so they are warned about */
+static Boolean CheckDropped(void)
+{
+    MarkovChainStats stats;
+    Boolean fitted = TRUE;
+    int i;
+
+    for (i = 0; i < kMarkovTopicCount; i++) {
+        if (gChains[i] == NULL)
+            continue;
+        MarkovChain_GetStats(gChains[i], &stats);
+        if (stats.droppedWords > 0) {
+            fprintf(stderr,
+                    "markov_train: error: %lu training words didn't fit in the %s model's "
+                    "dictionary of %d words and %u characters; raise MARKOV_DICT_WORDS or "
+                    "MARKOV_DICT_CHARS\n",
+                    stats.droppedWords, MarkovTopic_Name((MarkovTopic)i), stats.maxWords,
+                    stats.maxWordChars);
+            fitted = FALSE;
+        }
+        if (stats.droppedContexts > 0) {
+            fprintf(stderr,
+                    "markov_train: warning: %lu training contexts didn't fit in the %s model "
+                    "even with room for %d; lower MARKOV_ORDER or train less text to keep them\n",
+                    stats.droppedContexts, MarkovTopic_Name((MarkovTopic)i), stats.maxNodes);
+        }
+    }
+    return fitted;
+}
+
+/* Percentage of a whole, 0 if there is none */
+static double Percent(double part, double whole)
+{
+    return (whole > 0) ? 100 * part / whole : 0;
+}
+
+/* Print how full the chain is and the shape of its contents, to size its capacity by */
+static void PrintShape(const MarkovChain *chain)
+{
+    MarkovChainStats stats;
+    int i;
+
+    MarkovChain_GetStats(chain, &stats);
+    printf("markov_train:   contexts %d of %d (%.1f%%), by order", stats.nodeCount,
+           stats.maxNodes, Percent(stats.nodeCount, stats.maxNodes));
+    for (i = 0; i < chain->order; i++) {
+        printf(" %d", stats.nodesByOrder[i]);
+    }
+    printf(", %.1f%% start a sentence\n", Percent(stats.startNodes, stats.nodeCount));
+
+    printf("markov_train:   contexts by followers");
+    for (i = 0; i < kMarkovFollowerBuckets; i++) {
+        if (i < 2)
+            printf(" %d:%d", i, stats.followerHistogram[i]);
+        else
+            printf(" %d-%d:%d", 1 << (i - 1), (1 << i) - 1, stats.followerHistogram[i]);
+    }
+    printf("\n");
+
+    printf("markov_train:   %.2f followers per context, at most %d; %d contexts at %d, %ld "
+           "counts at %lu\n",
+           (stats.nodeCount > 0) ? (double)stats.followers / stats.nodeCount : 0.0,
+           stats.mostFollowers, stats.saturatedNodes, MAX_FOLLOWERS, stats.saturatedCounts,
+           (unsigned long)kMaxFollowerCount);
+
+    printf("markov_train:   pool %u of %u (%.1f%%), words %d of %d (%.1f%%), text %u of %u "
+           "(%.1f%%), %ld bytes of memory\n",
+           stats.poolUsed, stats.poolSize, Percent(stats.poolUsed, stats.poolSize),
+           stats.wordCount, stats.maxWords, Percent(stats.wordCount, stats.maxWords),
+           stats.wordChars, stats.maxWordChars, Percent(stats.wordChars, stats.maxWordChars),
+           stats.memoryBytes);
+
+    printf("markov_train:   %lu lookups, %.2f probes on average, %u at most, %d slots\n",
+           stats.lookup.lookups,
+           (stats.lookup.lookups > 0) ? (double)stats.lookup.probes / stats.lookup.lookups : 0.0,
+           stats.lookup.maxProbes, stats.lookup.tableSize);
+}
+
+/* Write a model as a Rez data resource, named for its topic unless it is the general model */
+static void WriteRez(FILE *out, MarkovTopic topic, const unsigned char *model, long size)
+{
+    unsigned long type = MARKOV_MODEL_RES_TYPE;
+    long i;
+
+    fprintf(out, "\ndata '%c%c%c%c' (%d, \"Markov Model", (int)(type >> 24) & 0xFF,
+            (int)(type >> 16) & 0xFF, (int)(type >> 8) & 0xFF, (int)type & 0xFF,
+            MARKOV_MODEL_RES_ID + topic);
+    if (topic != kMarkovTopicGeneral)
+        fprintf(out, " %s", MarkovTopic_Name(topic));
+    fprintf(out, "\", purgeable) {\n");
+
+    for (i = 0; i < size; i++) {
+        if (i % 16 == 0)
+            fprintf(out, "    $\"");
+        fprintf(out, "%02X", model[i]);
+        if (i % 16 == 15 || i == size - 1)
+            fprintf(out, "\"\n");
+        else if (i % 2 == 1)
+            fprintf(out, " ");
+    }
+
+    fprintf(out, "};\n");
+}
+
+/* Serialize a chain, returns NULL if that fails */
+static unsigned char *SaveModel(const MarkovChain *chain, long *size)
+{
+    unsigned char *model;
+
+    *size = MarkovChain_SavedSize(chain);
+    model = malloc(*size);
+    if (model == NULL || MarkovChain_Save(chain, model, *size) != *size) {
+        fprintf(stderr, "markov_train: couldn't serialize the model\n");
+        free(model);
+        return NULL;
+    }
+    return model;
+}
+
+/* Prune each model until a chain of the app's capacity has room for it, then move it into one
+ * the way the app loads it, so what is saved and measured from here on is what the app gets.
+ * Returns FALSE if one doesn't load, which only its dictionary can stop now. The general model
+ * is pruned last, so that also drops the words the others no longer use from the dictionary it
+ * saves; it is loaded first, as the others share its dictionary */
+static Boolean FitModels(Boolean splitTopics)
+{
+    MarkovChain *fitted[kMarkovTopicCount];
+    MarkovChainStats stats;
+    unsigned char *model;
+    long size;
+    short capacity;
+    Boolean loaded = TRUE;
+    int i;
+
+    for (i = kMarkovTopicCount - 1; i >= 0; i--) {
+        if (gChains[i] == NULL)
+            continue;
+        capacity = MarkovChain_Capacity(gChains[i]);
+        if (capacity > 0 && capacity <= MAX_NODES)
+            continue;
+
+        MarkovChain_PruneToCapacity(gChains[i], MAX_NODES);
+        if (splitTopics)
+            printf("markov_train: %s model\n", MarkovTopic_Name((MarkovTopic)i));
+        PrintStats("fitted", gChains[i]);
+    }
+
+    for (i = 0; i < kMarkovTopicCount; i++) {
+        fitted[i] = NULL;
+        if (gChains[i] == NULL || !loaded)
+            continue;
+        if (i == kMarkovTopicGeneral) {
+            fitted[i] = malloc(MarkovChain_StorageSize(MAX_NODES));
+            if (fitted[i] != NULL)
+                MarkovChain_Init(fitted[i], MAX_NODES);
+        }
+        else {
+            fitted[i] = malloc(MarkovChain_SharedStorageSize(
+                MAX_NODES, fitted[kMarkovTopicGeneral]->dictionary->maxWords));
+            if (fitted[i] != NULL)
+                MarkovChain_InitShared(fitted[i], MAX_NODES,
+                                       fitted[kMarkovTopicGeneral]->dictionary);
+        }
+        model = SaveModel(gChains[i], &size);
+        if (fitted[i] == NULL || model == NULL) {
+            fprintf(stderr, "markov_train: out of memory\n");
+            loaded = FALSE;
+        }
+        else if (!MarkovChain_Load(fitted[i], model, size)) {
+            MarkovChain_GetStats(gChains[i], &stats);
+            fprintf(stderr,
+                    "markov_train: error: the %s model's %d words and %u characters don't fit "
+                    "the app's dictionary; raise MARKOV_DICT_WORDS or MARKOV_DICT_CHARS\n",
+                    MarkovTopic_Name((MarkovTopic)i), stats.wordCount, stats.wordChars);
+            loaded = FALSE;
+        }
+        free(model);
+    }
+
+    for (i = 0; i < kMarkovTopicCount; i++) {
+        if (loaded) {
+            free(gChains[i]);
+            gChains[i] = fitted[i];
+        }
+        else {
+            free(fitted[i]);
+        }
+    }
+    return loaded;
+}
+
+int main(int argc, char **argv)
+{
+    const char *outputPath = NULL;
+    int writeRez           = 0;
+    int splitTopics        = 0;
+    long budget            = 0;
+    int threads            = 0;
+    int printShape         = 0;
+    short trainingNodes;
+    long sizes[kMarkovTopicCount];
+    long totalSize   = 0;
+    long corpusBytes = 0;
+    double started, seconds;
+    long fileBytes;
+    unsigned char *model;
+    MarkovTopic topic;
+    long size;
+    FILE *out;
+    int firstCorpus, i;
+
+    for (i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "-r") == 0) {
+            writeRez = 1;
+        }
+        else if (strcmp(argv[i], "-t") == 0) {
+            splitTopics = 1;
+        }
+        else if (strcmp(argv[i], "-b") == 0 && i + 1 < argc) {
+            budget = atol(argv[++i]);
+        }
+        else if (strcmp(argv[i], "-j") == 0 && i + 1 < argc) {
+            threads = atoi(argv[++i]);
+            if (threads < 1 || threads > kMaxThreads) {
+                fprintf(stderr, "markov_train: -j takes 1 to %d threads\n", kMaxThreads);
+                return 1;
+            }
+        }
+        else if (strcmp(argv[i], "-s") == 0) {
+            printShape = 1;
+        }
+        else if (strcmp(argv[i], "-o") == 0 && i + 1 < argc) {
+            outputPath = argv[++i];
+        }
+        else if (argv[i][0] != '-' || strcmp(argv[i], "-") == 0) {
+            break; /* The corpus files */
+        }
+        else {
+            Usage(argv[0]);
+            return 1;
+        }
+    }
+    firstCorpus = i;
+
+    /* A raw model file holds one model, so sub-models only go in Rez source. Corpus files have
+     * no topics to split, and only they can be counted in shards */
+    if (outputPath == NULL || (splitTopics && (!writeRez || firstCorpus < argc)) ||
+        (threads > 0 && firstCorpus == argc)) {
+        Usage(argv[0]);
+        return 1;
+    }
+
+    /* Train what the app would train at startup, minus the runtime system facts, with room
+     * for all of it if any chain has that much. Counting picks the contexts to keep itself, so
+     * it fills a chain of the app's capacity. Sub-models get as much room, as they are trimmed
+     * to what they use when loaded */
+    trainingNodes                = (threads > 0) ? MAX_NODES : kTrainingNodes;
+    gChains[kMarkovTopicGeneral] = malloc(MarkovChain_StorageSize(trainingNodes));
+    if (gChains[kMarkovTopicGeneral] == NULL) {
+        fprintf(stderr, "markov_train: out of memory\n");
+        return 1;
+    }
+    MarkovChain_Init(gChains[kMarkovTopicGeneral], trainingNodes);
+
+    for (topic = kMarkovTopicGeneral + 1; splitTopics && topic < kMarkovTopicCount; topic++) {
+        gChains[topic] = malloc(MarkovChain_SharedStorageSize(
+            kTrainingNodes, gChains[kMarkovTopicGeneral]->dictionary->maxWords));
+        if (gChains[topic] == NULL) {
+            fprintf(stderr, "markov_train: out of memory\n");
+            return 1;
+        }
+        MarkovChain_InitShared(gChains[topic], kTrainingNodes,
+                               gChains[kMarkovTopicGeneral]->dictionary);
+    }
+
+    if (firstCorpus < argc) {
+        started = Now();
+        if (threads > 0) {
+            corpusBytes = CountCorpus(gChains[kMarkovTopicGeneral], argv + firstCorpus,
+                                      argc - firstCorpus, threads);
+            if (corpusBytes < 0)
+                return 1;
+        }
+        for (i = firstCorpus; threads == 0 && i < argc; i++) {
+            fileBytes = TrainFile(gChains[kMarkovTopicGeneral], argv[i]);
+            if (fileBytes < 0)
+                return 1;
+            corpusBytes += fileBytes;
+        }
+        seconds = Now() - started;
+        printf("markov_train: %ld bytes in %.2f s, %.1f MB/s, peak memory %ld KB, %lu words "
+               "and %lu contexts dropped\n",
+               corpusBytes, seconds, (seconds > 0) ? corpusBytes / seconds / 1e6 : 0.0,
+               PeakMemoryKB(), gChains[kMarkovTopicGeneral]->droppedWords,
+               gChains[kMarkovTopicGeneral]->droppedContexts);
+    }
+    else if (splitTopics) {
+        /* The general model learns every entry, in the same order as without sub-models */
+        for (i = 0; i < StaticTrainingCount(); i++) {
+            TrainMarkov(StaticTrainingEntry(i, &topic));
+            if (topic != kMarkovTopicGeneral)
+                MarkovChain_Train(gChains[topic], StaticTrainingEntry(i, NULL));
+        }
+    }
+    else {
+        LoadStaticTrainingData();
+    }
+
+    for (i = 0; i < kMarkovTopicCount; i++) {
+        if (gChains[i] == NULL)
+            continue;
+        if (splitTopics)
+            printf("markov_train: %s model\n", MarkovTopic_Name((MarkovTopic)i));
+        PrintStats("trained", gChains[i]);
+    }
+
+    /* The app has every word of the static corpus, so its model must too; and a corpus model
+     * missing words would quietly lose every sentence they were in */
+    if (!CheckDropped() || !FitModels(splitTopics))
+        return 1;
+
+    for (i = 0; i < kMarkovTopicCount; i++) {
+        sizes[i] = (gChains[i] != NULL) ? MarkovChain_SavedSize(gChains[i]) : 0;
+        totalSize += sizes[i];
+    }
+
+    /* Each model gets its share of the budget. The general model goes last, so pruning it also
+     * drops the words the others no longer use from the dictionary it saves */
+    if (budget > 0 && totalSize > budget) {
+        for (i = kMarkovTopicCount - 1; i >= 0; i--) {
+            if (gChains[i] == NULL)
+                continue;
+            size = (long)((double)budget * sizes[i] / totalSize);
+            if (MarkovChain_PruneToSize(gChains[i], size) > size)
+                fprintf(stderr, "markov_train: warning: no model fits in %ld bytes\n", size);
+            if (splitTopics)
+                printf("markov_train: %s model\n", MarkovTopic_Name((MarkovTopic)i));
+            PrintStats("pruned", gChains[i]);
+        }
+    }
+
+    /* The models as they are saved */
+    for (i = 0; printShape && i < kMarkovTopicCount; i++) {
+        if (gChains[i] == NULL)
+            continue;
+        printf("markov_train: %s model\n", MarkovTopic_Name((MarkovTopic)i));
+        PrintShape(gChains[i]);
+    }
+
+    out = fopen(outputPath, writeRez ? "w" : "wb");
+    if (out == NULL) {
+        perror(outputPath);
+        return 1;
+    }
+
+    if (writeRez) {
+        fprintf(out, "/* Generated by tools/markov_train from %s */\n",
+                (firstCorpus < argc) ? "corpus files" : "src/chatbot/markov_data.c");
+    }
+    for (topic = kMarkovTopicGeneral; topic < kMarkovTopicCount; topic++) {
+        if (gChains[topic] == NULL)
+            continue;
+        model = SaveModel(gChains[topic], &size);
+        if (model == NULL)
+            return 1;
+
+        if (writeRez) {
+            WriteRez(out, topic, model, size);
+        }
+        else {
+            fwrite(model, 1, size, out);
+        }
+        free(model);
+    }
+
+    if (fclose(out) != 0) {
+        perror(outputPath);
+        return 1;
+    }
+
+    return 0;
+}